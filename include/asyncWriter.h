@@ -0,0 +1,112 @@
+// Copyright(c) 2016 - Costantino Grana, Federico Bolelli, Lorenzo Baraldi and Roberto Vezzani
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// *Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+// 
+// * Neither the name of YACCLAB nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Bounded queue of output jobs (color label images, middle results, ...) executed by background threads, 
+// so that tests do not stall on image encoding and disk writes between timed runs. push() blocks while 
+// the queue is full, which bounds the memory held by pending jobs. Jobs must own their data (e.g. capture 
+// cv::Mat by value) and must not depend on each other's order. With 0 threads jobs are run by push().
+class asyncWriter{
+public:
+	asyncWriter(unsigned threads, size_t capacity = 64) : _capacity(std::max<size_t>(capacity, 1)) {
+		for (unsigned t = 0; t < threads; ++t)
+			_threads.push_back(std::thread(&asyncWriter::work, this));
+	}
+
+	~asyncWriter(){
+		flush();
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_stop = true;
+		}
+		_not_empty.notify_all();
+		for (size_t t = 0; t < _threads.size(); ++t)
+			_threads[t].join();
+	}
+
+	asyncWriter(const asyncWriter&) = delete;
+	asyncWriter& operator=(const asyncWriter&) = delete;
+
+	void push(std::function<void()> job){
+		if (_threads.empty()){
+			job();
+			return;
+		}
+		std::unique_lock<std::mutex> lock(_mutex);
+		_not_full.wait(lock, [this]{ return _jobs.size() < _capacity; });
+		_jobs.push_back(std::move(job));
+		lock.unlock();
+		_not_empty.notify_one();
+	}
+
+	// Wait until all the pushed jobs are done
+	void flush(){
+		std::unique_lock<std::mutex> lock(_mutex);
+		_idle.wait(lock, [this]{ return _jobs.empty() && _running == 0; });
+	}
+
+private:
+	size_t _capacity;
+	std::vector<std::thread> _threads;
+	std::deque<std::function<void()>> _jobs;
+	unsigned _running = 0;
+	bool _stop = false;
+	std::mutex _mutex;
+	std::condition_variable _not_empty, _not_full, _idle;
+
+	void work(){
+		for (;;){
+			std::unique_lock<std::mutex> lock(_mutex);
+			_not_empty.wait(lock, [this]{ return _stop || !_jobs.empty(); });
+			if (_jobs.empty())
+				return; // Stopped
+			std::function<void()> job = std::move(_jobs.front());
+			_jobs.pop_front();
+			_running++;
+			lock.unlock();
+			_not_full.notify_one();
+
+			job();
+
+			lock.lock();
+			_running--;
+			const bool idle = _jobs.empty() && _running == 0;
+			lock.unlock();
+			if (idle)
+				_idle.notify_all();
+		}
+	}
+};
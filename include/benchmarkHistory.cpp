@@ -0,0 +1,236 @@
+// Copyright(c) 2016 - Costantino Grana, Federico Bolelli, Lorenzo Baraldi and Roberto Vezzani
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// *Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+// 
+// * Neither the name of YACCLAB nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "benchmarkHistory.h"
+
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#endif
+
+using namespace cv;
+using namespace std;
+
+string getGitRevision(){
+	FILE *pipe = popen("git rev-parse --short HEAD", "r");
+	if (!pipe)
+		return "unknown";
+	char buffer[128] = { 0 };
+	string revision;
+	if (fgets(buffer, sizeof(buffer), pipe))
+		revision = buffer;
+	if (pclose(pipe) != 0)
+		return "unknown";
+	revision.erase(std::remove_if(revision.begin(), revision.end(), ::isspace), revision.end());
+	return revision.empty() ? "unknown" : revision;
+}
+
+bool getGitDirty(){
+	FILE *pipe = popen("git status --porcelain --untracked-files=no", "r");
+	if (!pipe)
+		return false;
+	char buffer[128] = { 0 };
+	const bool changes = fgets(buffer, sizeof(buffer), pipe) != NULL;
+	while (fgets(buffer, sizeof(buffer), pipe)); // Drain the output before closing
+	return pclose(pipe) == 0 && changes;
+}
+
+bool sameRun(const historyEntry& a, const historyEntry& b){
+	return a.revision == b.revision && a.dirty == b.dirty && a.host == b.host && a.compiler == b.compiler && a.date == b.date;
+}
+
+string runName(const historyEntry& entry){
+	return entry.revision + (entry.dirty ? "-dirty" : "") + " (" + (entry.compiler.empty() ? "unknown compiler" : entry.compiler) + ", " + entry.date + ")";
+}
+
+// File format (tab separated): revision, dirty (0/1), host, compiler, date, dataset, algorithm, comma separated samples. 
+// Lines of older files without dirty flag and compiler are still accepted.
+vector<historyEntry> loadHistory(const string& path){
+
+	vector<historyEntry> history;
+	ifstream is(path);
+	if (!is.is_open())
+		return history;
+
+	string line;
+	while (getline(is, line)){
+		if (line.empty() || line[0] == '#')
+			continue;
+		stringstream ss(line);
+		vector<string> fields;
+		string field;
+		while (getline(ss, field, '\t'))
+			fields.push_back(field);
+
+		historyEntry entry;
+		string samples;
+		if (fields.size() == 8){
+			entry.revision = fields[0];
+			entry.dirty = fields[1] == "1";
+			entry.host = fields[2];
+			entry.compiler = fields[3];
+			entry.date = fields[4];
+			entry.dataset = fields[5];
+			entry.algorithm = fields[6];
+			samples = fields[7];
+		}
+		else if (fields.size() == 6){
+			entry.revision = fields[0];
+			entry.host = fields[1];
+			entry.date = fields[2];
+			entry.dataset = fields[3];
+			entry.algorithm = fields[4];
+			samples = fields[5];
+		}
+		else
+			continue; // Malformed line
+		stringstream sss(samples);
+		string value;
+		while (getline(sss, value, ',')){
+			entry.samples.push_back(atof(value.c_str()));
+		}
+		history.push_back(entry);
+	}
+	return history;
+}
+
+bool appendHistory(const string& path, const string& revision, bool dirty, const hostInfo& host, const benchmarkResults& results){
+
+	ifstream exists(path);
+	const bool newFile = !exists.is_open();
+	exists.close();
+
+	ofstream os(path, ios::app);
+	if (!os.is_open())
+		return false;
+
+	if (newFile)
+		os << "#Revision\tDirty\tHost\tCompiler\tDate\tDataset\tAlgorithm\tSamples" << endl;
+
+	os.precision(10);
+	for (size_t d = 0; d < results.timings.size(); ++d){
+		const datasetTimings& t = results.timings[d];
+		for (int a = 0; a < t.test_totals.cols; ++a){
+			os << revision << "\t" << (dirty ? 1 : 0) << "\t" << host.hostname << "\t" << host.compiler << "\t" << host.date << "\t" << t.dataset << "\t" << cleanName(results.algorithms[a]) << "\t";
+			for (int test = 0; test < t.test_totals.rows; ++test){
+				os << (test ? "," : "") << t.test_totals(test, a);
+			}
+			os << endl;
+		}
+	}
+	return true;
+}
+
+bool previousRun(const vector<historyEntry>& history, const string& host, const string& revision, historyEntry& baseline){
+	// Entries are appended, so the last one is the most recent
+	for (size_t i = history.size(); i-- > 0;){
+		if (history[i].host == host && (revision.empty() || history[i].revision == revision)){
+			baseline = history[i];
+			return true;
+		}
+	}
+	return false;
+}
+
+static void meanVariance(const vector<double>& samples, double& mean, double& variance){
+	mean = 0;
+	for (size_t i = 0; i < samples.size(); ++i)
+		mean += samples[i];
+	mean /= samples.size();
+	variance = 0;
+	for (size_t i = 0; i < samples.size(); ++i)
+		variance += (samples[i] - mean) * (samples[i] - mean);
+	variance = samples.size() > 1 ? variance / (samples.size() - 1) : 0;
+}
+
+// 95% one sided quantile of Student's t distribution with 'df' degrees of freedom 
+// (Cornish-Fisher expansion around the normal quantile, exact enough for df >= 2)
+static double tQuantile95(double df){
+	const double z = 1.6448536269514722, z3 = z * z * z, z5 = z3 * z * z, z7 = z5 * z * z;
+	return z + (z3 + z) / (4 * df) + (5 * z5 + 16 * z3 + 3 * z) / (96 * df * df) + (3 * z7 + 19 * z5 + 17 * z3 - 15 * z) / (384 * df * df * df);
+}
+
+vector<regressionCheck> checkRegressions(const vector<historyEntry>& history, const historyEntry& baseline, const benchmarkResults& results, double tolerance){
+
+	vector<regressionCheck> checks;
+	for (size_t d = 0; d < results.timings.size(); ++d){
+		const datasetTimings& t = results.timings[d];
+		for (int a = 0; a < t.test_totals.cols; ++a){
+
+			const string algorithm = cleanName(results.algorithms[a]);
+
+			// Samples of the baseline run
+			vector<double> base_samples;
+			for (size_t i = 0; i < history.size(); ++i){
+				if (sameRun(history[i], baseline) && history[i].dataset == t.dataset && history[i].algorithm == algorithm)
+					base_samples.insert(base_samples.end(), history[i].samples.begin(), history[i].samples.end());
+			}
+			if (base_samples.empty())
+				continue;
+
+			vector<double> cur_samples;
+			for (int test = 0; test < t.test_totals.rows; ++test)
+				cur_samples.push_back(t.test_totals(test, a));
+
+			regressionCheck check;
+			check.dataset = t.dataset;
+			check.algorithm = algorithm;
+
+			double base_var, cur_var;
+			meanVariance(base_samples, check.baseline_mean, base_var);
+			meanVariance(cur_samples, check.current_mean, cur_var);
+			check.slowdown = (check.current_mean - check.baseline_mean) / check.baseline_mean;
+
+			// Welch's t-test
+			check.t = 0;
+			check.significant = false;
+			check.enough_samples = base_samples.size() > 1 && cur_samples.size() > 1;
+			if (check.enough_samples){
+				const double vb = base_var / base_samples.size(), vc = cur_var / cur_samples.size();
+				if (vb + vc > 0){
+					check.t = (check.current_mean - check.baseline_mean) / sqrt(vb + vc);
+					const double df = (vb + vc) * (vb + vc) / (vb * vb / (base_samples.size() - 1) + vc * vc / (cur_samples.size() - 1));
+					check.significant = check.t > tQuantile95(df);
+				}
+				else{
+					// No noise at all on both sides: any difference is significant
+					check.significant = check.current_mean > check.baseline_mean;
+				}
+			}
+			check.regression = check.significant && check.slowdown > tolerance;
+			checks.push_back(check);
+		}
+	}
+	return checks;
+}
@@ -0,0 +1,87 @@
+// Copyright(c) 2016 - Costantino Grana, Federico Bolelli, Lorenzo Baraldi and Roberto Vezzani
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// *Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+// 
+// * Neither the name of YACCLAB nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include <string>
+#include <vector>
+
+#include "resultsExporter.h"
+
+// One line of the history file: statistics of the total execution time on a dataset of an algorithm, 
+// measured by a run of the driver on a host at a given revision. Every test repetition of the 
+// averages test gives one sample. A run is identified by revision, dirty flag, host, compiler and date.
+struct historyEntry{
+	std::string revision;
+	bool dirty = false;					// true if the working copy had uncommitted changes
+	std::string host;
+	std::string compiler;
+	std::string date;
+	std::string dataset;
+	std::string algorithm;
+	std::vector<double> samples;		// Total execution time on the dataset in ms, one for every repetition
+};
+
+// Outcome of the comparison of an algorithm on a dataset with the baseline
+struct regressionCheck{
+	std::string dataset;
+	std::string algorithm;
+	double baseline_mean;
+	double current_mean;
+	double slowdown;					// Relative: (current - baseline) / baseline
+	double t;							// Welch's t statistic (0 if there are not enough samples)
+	bool enough_samples;				// false if a side has less than two samples: the check is skipped
+	bool significant;					// true if the slowdown is statistically significant (one sided, 95%)
+	bool regression;					// true if significant and greater than the tolerated slowdown
+};
+
+// Revision of the working copy as reported by git, "unknown" if it cannot be retrieved
+std::string getGitRevision();
+
+// true if tracked files of the working copy have uncommitted changes
+bool getGitDirty();
+
+// true if the two entries were measured by the same run
+bool sameRun(const historyEntry& a, const historyEntry& b);
+
+// Description of the run of an entry, for messages: revision (with "-dirty"), compiler and date
+std::string runName(const historyEntry& entry);
+
+// Load all the entries of the history file (an empty vector if the file does not exist)
+std::vector<historyEntry> loadHistory(const std::string& path);
+
+// Append the results of the current run to the history file
+bool appendHistory(const std::string& path, const std::string& revision, bool dirty, const hostInfo& host, const benchmarkResults& results);
+
+// Most recent run measured on 'host' (of 'revision' only, if not empty): any entry of the run is stored in 
+// 'baseline'. The same revision is not skipped, so that a run is compared with the previous one after changing 
+// the working copy, the compiler or the system. Returns false if there is none.
+bool previousRun(const std::vector<historyEntry>& history, const std::string& host, const std::string& revision, historyEntry& baseline);
+
+// Compare the current run with the entries of the baseline run. Welch's t-test needs at least two samples on 
+// both sides (at_testsNumber >= 2): checks with less are marked as skipped, never as passed.
+std::vector<regressionCheck> checkRegressions(const std::vector<historyEntry>& history, const historyEntry& baseline, const benchmarkResults& results, double tolerance);
@@ -0,0 +1,138 @@
+// Copyright(c) 2016 - Costantino Grana, Federico Bolelli, Lorenzo Baraldi and Roberto Vezzani
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// *Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+// 
+// * Neither the name of YACCLAB nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+// Geometry of a cache level
+struct cacheLevelConfig{
+	std::string name;
+	size_t size;				// Capacity in bytes
+	unsigned ways;				// Associativity
+	unsigned line;				// Line size in bytes
+};
+
+// Set associative cache level with LRU replacement. Only tags are stored: the simulation is 
+// driven by addresses and tells if every access hits or misses.
+class cacheLevel{
+public:
+	cacheLevel(const cacheLevelConfig& config) : _config(config){
+		_sets = _config.size / ((size_t)_config.line * _config.ways);
+		if (_sets == 0)
+			_sets = 1;
+		_tags = std::vector<uint64_t>(_sets * _config.ways, EMPTY);
+	}
+
+	// Return true on hit. On miss the line is loaded evicting the least recently used one of its set.
+	bool access(uint64_t address){
+		const uint64_t tag = address / _config.line;
+		uint64_t *set = _tags.data() + (tag % _sets) * _config.ways; // Ways are kept from the most to the least recently used
+		unsigned w = 0;
+		while (w < _config.ways - 1 && set[w] != tag)
+			++w;
+		const bool hit = set[w] == tag;
+		for (; w > 0; --w)
+			set[w] = set[w - 1];
+		set[0] = tag;
+		return hit;
+	}
+
+	void flush(){
+		std::fill(_tags.begin(), _tags.end(), EMPTY);
+	}
+
+	const cacheLevelConfig& config() const{
+		return _config;
+	}
+
+private:
+	static const uint64_t EMPTY = ~uint64_t(0);
+	cacheLevelConfig _config;
+	size_t _sets;
+	std::vector<uint64_t> _tags;
+};
+
+// Hierarchy of cache levels (L1, L2, LLC, ...) which counts hits and misses of every level 
+// separately for every type of data. An access goes to the next level only if it misses the 
+// previous one, and the missing line is loaded on every level it missed (non inclusive policy).
+class cacheModel{
+public:
+	cacheModel(const std::vector<cacheLevelConfig>& levels, unsigned types) : _types(types){
+		for (size_t l = 0; l < levels.size(); ++l)
+			_levels.push_back(cacheLevel(levels[l]));
+		_hits = std::vector<unsigned long long>(_levels.size() * _types, 0);
+		_misses = std::vector<unsigned long long>(_levels.size() * _types, 0);
+	}
+
+	void access(uint64_t address, unsigned type){
+		for (size_t l = 0; l < _levels.size(); ++l){
+			if (_levels[l].access(address)){
+				_hits[l * _types + type]++;
+				return;
+			}
+			_misses[l * _types + type]++;
+		}
+	}
+
+	// Empty all levels and clear statistics
+	void reset(){
+		for (size_t l = 0; l < _levels.size(); ++l)
+			_levels[l].flush();
+		std::fill(_hits.begin(), _hits.end(), 0);
+		std::fill(_misses.begin(), _misses.end(), 0);
+	}
+
+	size_t levels() const{
+		return _levels.size();
+	}
+
+	unsigned types() const{
+		return _types;
+	}
+
+	const cacheLevelConfig& config(size_t level) const{
+		return _levels[level].config();
+	}
+
+	unsigned long long hits(size_t level, unsigned type) const{
+		return _hits[level * _types + type];
+	}
+
+	unsigned long long misses(size_t level, unsigned type) const{
+		return _misses[level * _types + type];
+	}
+
+private:
+	unsigned _types;
+	std::vector<cacheLevel> _levels;
+	std::vector<unsigned long long> _hits;
+	std::vector<unsigned long long> _misses;
+};
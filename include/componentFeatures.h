@@ -0,0 +1,164 @@
+// Copyright(c) 2016 - Costantino Grana, Federico Bolelli, Lorenzo Baraldi and Roberto Vezzani
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// *Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+// 
+// * Neither the name of YACCLAB nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include "opencv2/opencv.hpp"
+#include "labelingAccess.h"
+#include <vector>
+#include <climits>
+#include <algorithm>
+
+// Features of the components collected while labeling, through the trackers of the first scans (see 
+// labelTracker in labelingAccess.h). Features are accumulated on provisional labels, and merged on the 
+// final labels once the equivalences have been flattened.
+
+// Tracker which counts the foreground pixels of every provisional label. 'block' is the side of the 
+// blocks labeled by the engine (2 for BBDT, 1 for pixel based engines).
+struct areaTracker : labelTracker{
+	const cv::Mat1b& img;
+	const int block;
+	std::vector<uint> areas;
+
+	areaTracker(const cv::Mat1b& img_, size_t Plength, int block_) : img(img_), block(block_), areas(Plength, 0) {}
+
+	template <typename RowT>
+	void labeled(const RowT& labels_row, int r, int c) {
+		const uint label = labels_row[c];
+		if (label == 0)
+			return;
+		if (block == 1){
+			areas[label]++;
+			return;
+		}
+		for (int y = r; y < r + block && y < img.rows; ++y){
+			const uchar * const img_row = img.ptr<uchar>(y);
+			for (int x = c; x < c + block && x < img.cols; ++x)
+				areas[label] += img_row[x] > 0;
+		}
+	}
+};
+
+// Remove from the flattened equivalences P the components with less than 'min_area' pixels: they are 
+// mapped to background and the other ones are renumbered contiguously, so that the second scan outputs 
+// the filtered labels. Returns the new number of labels (background included), as flattenL.
+template <typename EquivT>
+inline
+uint filterAreas(EquivT& P, uint lunique, uint nLabel, const std::vector<uint>& areas, uint min_area) {
+	std::vector<uint> component_areas(nLabel, 0);
+	for (uint l = 1; l < lunique; ++l)
+		component_areas[P[l]] += areas[l];
+
+	std::vector<uint> renumber(nLabel, 0);
+	uint k = 1;
+	for (uint l = 1; l < nLabel; ++l){
+		if (component_areas[l] >= min_area)
+			renumber[l] = k++;
+	}
+
+	for (uint l = 1; l < lunique; ++l)
+		P[l] = renumber[P[l]];
+	return k;
+}
+
+// Tracker which collects the bounding box (min and max row and column of the foreground pixels) of every 
+// provisional label. 'block' is the side of the blocks labeled by the engine, as in areaTracker.
+struct boxTracker : labelTracker{
+	const cv::Mat1b& img;
+	const int block;
+	std::vector<int> min_r, min_c, max_r, max_c;
+
+	boxTracker(const cv::Mat1b& img_, size_t Plength, int block_) : img(img_), block(block_), 
+		min_r(Plength, INT_MAX), min_c(Plength, INT_MAX), max_r(Plength, -1), max_c(Plength, -1) {}
+
+	void add(uint label, int r, int c) {
+		min_r[label] = std::min(min_r[label], r);
+		min_c[label] = std::min(min_c[label], c);
+		max_r[label] = std::max(max_r[label], r);
+		max_c[label] = std::max(max_c[label], c);
+	}
+
+	template <typename RowT>
+	void labeled(const RowT& labels_row, int r, int c) {
+		const uint label = labels_row[c];
+		if (label == 0)
+			return;
+		if (block == 1){
+			add(label, r, c);
+			return;
+		}
+		for (int y = r; y < r + block && y < img.rows; ++y){
+			const uchar * const img_row = img.ptr<uchar>(y);
+			for (int x = c; x < c + block && x < img.cols; ++x){
+				if (img_row[x] > 0)
+					add(label, y, x);
+			}
+		}
+	}
+};
+
+// Merge the boxes of the provisional labels on the final labels of the flattened equivalences P. 'boxes' 
+// is indexed by label (boxes[0] is empty).
+template <typename EquivT>
+inline
+void mergeBoxes(const EquivT& P, uint lunique, uint nLabel, const boxTracker& tracker, std::vector<cv::Rect>& boxes) {
+	std::vector<int> min_r(nLabel, INT_MAX), min_c(nLabel, INT_MAX), max_r(nLabel, -1), max_c(nLabel, -1);
+	for (uint l = 1; l < lunique; ++l){
+		const uint f = P[l];
+		min_r[f] = std::min(min_r[f], tracker.min_r[l]);
+		min_c[f] = std::min(min_c[f], tracker.min_c[l]);
+		max_r[f] = std::max(max_r[f], tracker.max_r[l]);
+		max_c[f] = std::max(max_c[f], tracker.max_c[l]);
+	}
+
+	boxes.assign(nLabel, cv::Rect());
+	for (uint l = 1; l < nLabel; ++l)
+		boxes[l] = cv::Rect(min_c[l], min_r[l], max_c[l] - min_c[l] + 1, max_r[l] - min_r[l] + 1);
+}
+
+// Bounding boxes of the components of a label image with labels from 1 to nLabel - 1, indexed by label as 
+// mergeBoxes (boxes[0] is empty)
+inline
+void labelsBoxes(const cv::Mat1i& imgLabels, uint nLabel, std::vector<cv::Rect>& boxes) {
+	std::vector<int> min_r(nLabel, INT_MAX), min_c(nLabel, INT_MAX), max_r(nLabel, -1), max_c(nLabel, -1);
+	for (int r = 0; r < imgLabels.rows; ++r){
+		const int * const labels_row = imgLabels.ptr<int>(r);
+		for (int c = 0; c < imgLabels.cols; ++c){
+			const int l = labels_row[c];
+			if (l > 0){
+				min_r[l] = std::min(min_r[l], r);
+				min_c[l] = std::min(min_c[l], c);
+				max_r[l] = std::max(max_r[l], r);
+				max_c[l] = std::max(max_c[l], c);
+			}
+		}
+	}
+
+	boxes.assign(nLabel, cv::Rect());
+	for (uint l = 1; l < nLabel; ++l)
+		boxes[l] = cv::Rect(min_c[l], min_r[l], max_c[l] - min_c[l] + 1, max_r[l] - min_r[l] + 1);
+}
@@ -0,0 +1,223 @@
+// Copyright(c) 2016 - Costantino Grana, Federico Bolelli, Lorenzo Baraldi and Roberto Vezzani
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// *Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+// 
+// * Neither the name of YACCLAB nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "contourTracing.h"
+
+#include <climits>
+
+using namespace cv;
+using namespace std;
+
+// Neighbors in clockwise order (y grows downwards), starting from north
+static const int kDx[8] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+static const int kDy[8] = { -1, -1, 0, 1, 1, 1, 0, -1 };
+
+// First neighbor of 'p' labeled 'label', searching clockwise from the one after direction 'from'. 
+// Returns its direction, -1 if 'p' is isolated.
+static inline int nextNeighbor(const Mat1i& imgLabels, Point p, uint label, int from){
+	for (int i = 1; i <= 8; ++i){
+		const int d = (from + i) & 7;
+		const int x = p.x + kDx[d], y = p.y + kDy[d];
+		if (x >= 0 && y >= 0 && x < imgLabels.cols && y < imgLabels.rows && imgLabels.ptr<uint>(y)[x] == label)
+			return d;
+	}
+	return -1;
+}
+
+// Marks of the possible first pixels of holes in the label image (see traceContours), never reached by labels
+static const uint kHoleStart = UINT_MAX, kSwept = UINT_MAX - 1;
+
+// nextNeighbor which also clears the mark of the south neighbor of 'p' if it sweeps it or starts from it: that 
+// pixel is on the side of the contour, so it is not the first pixel of a hole of the component unless the contour 
+// is of that hole
+static inline int sweepNeighbor(Mat1i& imgLabels, Point p, uint label, int from){
+	for (int i = 0; i <= 8; ++i){
+		const int d = (from + i) & 7;
+		const int x = p.x + kDx[d], y = p.y + kDy[d];
+		if (x >= 0 && y >= 0 && x < imgLabels.cols && y < imgLabels.rows){
+			uint& value = imgLabels.ptr<uint>(y)[x];
+			if (i > 0 && value == label)
+				return d;
+			if (d == 4 && value == kHoleStart)
+				value = kSwept;
+		}
+	}
+	return -1;
+}
+
+// Contour traced from 'start', whose neighbor in direction 'from' is outside the component (north for outer 
+// contours, south for holes). next(p, from) gives the direction of the next contour pixel from p.
+template <typename NextT>
+static void traceContour(Point start, int from, vector<Point>& contour, NextT next){
+	contour.push_back(start);
+
+	const int first = next(start, from);
+	if (first < 0)
+		return;
+
+	Point p = start;
+	int d = first;
+	for (;;){
+		p += Point(kDx[d], kDy[d]);
+		// Background neighbor checked before moving, seen from the new pixel
+		const int backtrack = (d & 1) ? (d + 5) & 7 : (d + 6) & 7;
+		d = next(p, backtrack);
+		if (p == start && d == first)
+			break;
+		contour.push_back(p);
+	}
+}
+
+void traceOuterContours(const Mat1i& imgLabels, const vector<Point>& starts, vector<vector<Point>>& contours){
+
+	contours.assign(starts.size(), vector<Point>());
+	for (size_t label = 1; label < starts.size(); ++label){
+		// The north neighbor of the start pixel is background
+		traceContour(starts[label], 0, contours[label], [&](Point p, int from) { return nextNeighbor(imgLabels, p, (uint)label, from); });
+	}
+}
+
+void traceContours(Mat1i& imgLabels, const vector<Point>& starts, const vector<Point>& hole_starts, vector<vector<Point>>& contours, vector<vector<Point>>& holes, vector<uint>& parents){
+
+	for (const Point& x : hole_starts)
+		imgLabels.ptr<uint>(x.y)[x.x] = kHoleStart;
+
+	// Outer contours sweep the background around their components, which is not in their holes
+	contours.assign(starts.size(), vector<Point>());
+	for (size_t label = 1; label < starts.size(); ++label){
+		traceContour(starts[label], 0, contours[label], [&](Point p, int from) { return sweepNeighbor(imgLabels, p, (uint)label, from); });
+	}
+
+	// A hole contour sweeps the pixels of the hole below its pixels, which include the other possible starts of 
+	// the hole. Starts are visited in row major order, so the first pixel of every hole is reached first.
+	holes.clear();
+	parents.clear();
+	for (const Point& x : hole_starts){
+		uint& mark = imgLabels.ptr<uint>(x.y)[x.x];
+		if (mark != kHoleStart)
+			continue;
+		mark = kSwept;
+		// The south neighbor of the start pixel is in the hole
+		const Point start(x.x, x.y - 1);
+		const uint parent = imgLabels.ptr<uint>(start.y)[start.x];
+		holes.push_back(vector<Point>());
+		parents.push_back(parent);
+		traceContour(start, 4, holes.back(), [&](Point p, int from) { return sweepNeighbor(imgLabels, p, parent, from); });
+	}
+
+	for (const Point& x : hole_starts)
+		imgLabels.ptr<uint>(x.y)[x.x] = 0;
+}
+
+static bool rowMajorLess(const Point& a, const Point& b){
+	return a.y < b.y || (a.y == b.y && a.x < b.x);
+}
+
+// Distinct pixels of a contour, in row major order
+static vector<Point> contourPixels(vector<Point> contour){
+	sort(contour.begin(), contour.end(), rowMajorLess);
+	contour.erase(unique(contour.begin(), contour.end()), contour.end());
+	return contour;
+}
+
+bool contoursMatchLabels(const Mat1i& imgLabels, uint nLabel, const vector<vector<Point>>& contours, const vector<vector<Point>>& holes, const vector<uint>& parents){
+	const int h = imgLabels.rows, w = imgLabels.cols;
+	static const int kDx4[4] = { 0, 1, 0, -1 };
+	static const int kDy4[4] = { -1, 0, 1, 0 };
+
+	// Regions of background: 0 if they touch the border of the image, otherwise holes numbered from 1 in row 
+	// major order of their first pixel, with their parent (the component above the first pixel)
+	Mat1i regions(h, w, -1);
+	vector<uint> region_parents(1, 0);
+	vector<Point> region;
+	for (int r = 0; r < h; ++r){
+		for (int c = 0; c < w; ++c){
+			if (imgLabels(r, c) != 0 || regions(r, c) >= 0)
+				continue;
+			region.assign(1, Point(c, r));
+			regions(r, c) = 0;
+			bool touches_border = false;
+			for (size_t i = 0; i < region.size(); ++i){
+				const Point p = region[i];
+				for (int d = 0; d < 4; ++d){
+					const int x = p.x + kDx4[d], y = p.y + kDy4[d];
+					if (x < 0 || y < 0 || x >= w || y >= h)
+						touches_border = true;
+					else if (imgLabels(y, x) == 0 && regions(y, x) < 0){
+						regions(y, x) = 0;
+						region.push_back(Point(x, y));
+					}
+				}
+			}
+			if (touches_border)
+				continue;
+			const int id = (int)region_parents.size();
+			region_parents.push_back(imgLabels(r - 1, c));
+			for (const Point& p : region)
+				regions(p.y, p.x) = id;
+		}
+	}
+
+	// Expected contour pixels, in row major order
+	vector<vector<Point>> outer(nLabel), inner(region_parents.size());
+	for (int r = 0; r < h; ++r){
+		for (int c = 0; c < w; ++c){
+			const int label = imgLabels(r, c);
+			if (label == 0)
+				continue;
+			if (label < 0 || (uint)label >= nLabel)
+				return false;
+			for (int d = 0; d < 4; ++d){
+				const int x = c + kDx4[d], y = r + kDy4[d];
+				vector<Point> *expected;
+				if (x < 0 || y < 0 || x >= w || y >= h)
+					expected = &outer[label];
+				else if (imgLabels(y, x) != 0)
+					continue;
+				else if (regions(y, x) > 0 && region_parents[regions(y, x)] == (uint)label)
+					expected = &inner[regions(y, x)];
+				else
+					expected = &outer[label];
+				if (expected->empty() || expected->back() != Point(c, r))
+					expected->push_back(Point(c, r));
+			}
+		}
+	}
+
+	if (contours.size() != nLabel || holes.size() + 1 != region_parents.size() || parents.size() != holes.size())
+		return false;
+	for (uint l = 1; l < nLabel; ++l){
+		if (contourPixels(contours[l]) != outer[l])
+			return false;
+	}
+	for (size_t i = 0; i < holes.size(); ++i){
+		if (parents[i] != region_parents[i + 1] || contourPixels(holes[i]) != inner[i + 1])
+			return false;
+	}
+	return true;
+}
@@ -0,0 +1,59 @@
+// Copyright(c) 2016 - Costantino Grana, Federico Bolelli, Lorenzo Baraldi and Roberto Vezzani
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// *Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+// 
+// * Neither the name of YACCLAB nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include "opencv2/opencv.hpp"
+#include <vector>
+
+// Outer contours of the components of a label image, traced with Moore's neighbor tracing (8-connectivity, 
+// clockwise in image coordinates, Jacob's stopping criterion). Tracing starts from a given pixel of every 
+// component whose north neighbor is outside the component and not in one of its holes (e.g. the first 
+// pixel of the component in row major order), so only contour pixels are visited: the cost is proportional 
+// to the length of the contours, not to the size of the image. Holes are traced by traceContours.
+// 'starts' and 'contours' are indexed by label (index 0, background, is ignored and left empty). Contours 
+// list every contour pixel once per visit; single pixel components have a one point contour.
+void traceOuterContours(const cv::Mat1i& imgLabels, const std::vector<cv::Point>& starts, std::vector<std::vector<cv::Point>>& contours);
+
+// traceOuterContours which also traces the contours of the holes, with the hole on the other side. Holes are the 
+// regions of background (4-connected, as foreground is 8-connected) which do not touch the border of the image, 
+// and every hole is enclosed by a single component, its parent. The first pixel of a hole in row major order has 
+// its parent above and on the left: 'hole_starts' are the background pixels of this kind, recorded while 
+// labeling in row major order (those on the border of the image may be left out). They are marked in the label 
+// image, and every contour clears the marks of the pixels below its pixels on its side (swept while searching the 
+// next contour pixel, or where the search starts from): outer contours clear those outside their component, and a 
+// hole contour those in its hole but the first. The marks left when a start is reached are those of the first 
+// pixels of holes, whose contours are traced from the pixel above. No other pixel is visited, and the label image 
+// is restored. 'holes' are sorted by their first pixel in row major order, and 'parents' holds the label of the 
+// parent of every hole.
+void traceContours(cv::Mat1i& imgLabels, const std::vector<cv::Point>& starts, const std::vector<cv::Point>& hole_starts, std::vector<std::vector<cv::Point>>& contours, std::vector<std::vector<cv::Point>>& holes, std::vector<uint>& parents);
+
+// Check of outer contours ('contours', indexed by label) and of hole contours ('holes' and 'parents', as given by 
+// traceContours) against the labels: the pixels of a component 4-adjacent to one of its holes must be on the 
+// contour of that hole, and the other ones 4-adjacent to background or to the border of the image on its outer 
+// contour. Holes are found again by a breadth first visit of the background.
+bool contoursMatchLabels(const cv::Mat1i& imgLabels, uint nLabel, const std::vector<std::vector<cv::Point>>& contours, const std::vector<std::vector<cv::Point>>& holes, const std::vector<uint>& parents);
@@ -0,0 +1,329 @@
+// Copyright(c) 2016 - Costantino Grana, Federico Bolelli, Lorenzo Baraldi and Roberto Vezzani
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// *Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+// 
+// * Neither the name of YACCLAB nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include <vector>
+#include <algorithm>
+#include "opencv2/opencv.hpp"
+#include "equivalenceSolverSuzuki.h"
+
+// Union-find strategies as policies of the engines, which are templates on the equivalence structure: a solver is 
+// used in place of the array of labels P, with the same interface (P[l] to create a label and, after flattenL, to 
+// read the final one; set_union to merge two labels; flattenL to number the components consecutively in the order 
+// of their smallest label). Solvers have room for 'length' labels, as the arrays allocated by the engines.
+//  - ufSuzuki: the functions above (link to the smallest root, full path compression with setRoot)
+//  - ufHalving, ufSplitting: link to the smallest root, with path halving or path splitting
+//  - ufRank: union by rank, with full path compression (roots are not the smallest labels)
+//  - ufSize: union by size, with full path compression (roots are not the smallest labels)
+//  - ufRem: Rem's algorithm with splicing, linking to the smallest label
+//  - ufLists: the interleaved lists of CCIT_OPT, where every label points directly to the representative of its 
+//    set, and the labels of the other set are relinked when two sets are merged
+template <typename SolverT>
+class equivalenceSolver {
+public:
+	explicit equivalenceSolver(size_t length) : P((uint *)cv::fastMalloc(sizeof(uint)* length)) {}
+	~equivalenceSolver() { cv::fastFree(P); }
+
+	equivalenceSolver(const equivalenceSolver&) = delete;
+	equivalenceSolver& operator=(const equivalenceSolver&) = delete;
+
+	uint& operator[](uint i) { return P[i]; }
+	uint operator[](uint i) const { return P[i]; }
+
+protected:
+	uint *P;
+};
+
+template <typename SolverT>
+inline static
+uint set_union(equivalenceSolver<SolverT> &P, uint i, uint j){
+	COUNT_EVENT(CT_UNIONS);
+	return static_cast<SolverT&>(P).merge(i, j);
+}
+
+template <typename SolverT>
+inline static
+uint flattenL(equivalenceSolver<SolverT> &P, uint length){
+	return static_cast<SolverT&>(P).flatten(length);
+}
+
+class ufSuzuki : public equivalenceSolver<ufSuzuki> {
+public:
+	explicit ufSuzuki(size_t length) : equivalenceSolver(length) {}
+
+	uint merge(uint i, uint j) {
+		// Same steps of set_union on arrays, without counting the union twice
+		uint root = findRoot(P, i);
+		if (i != j){
+			uint rootj = findRoot(P, j);
+			if (root > rootj){
+				root = rootj;
+			}
+			setRoot(P, j, root);
+		}
+		setRoot(P, i, root);
+		return root;
+	}
+
+	uint flatten(uint length) { return ::flattenL(P, length); }
+};
+
+class ufHalving : public equivalenceSolver<ufHalving> {
+public:
+	explicit ufHalving(size_t length) : equivalenceSolver(length) {}
+
+	// Every node of the path is linked to its grandparent, skipping every other one
+	uint root(uint i) {
+		while (P[i] < i){
+			COUNT_EVENT(CT_FINDROOT_STEPS);
+			P[i] = P[P[i]];
+			i = P[i];
+		}
+		return i;
+	}
+
+	uint merge(uint i, uint j) {
+		const uint rooti = root(i), rootj = root(j);
+		if (rooti < rootj){
+			P[rootj] = rooti;
+			return rooti;
+		}
+		P[rooti] = rootj;
+		return rootj;
+	}
+
+	uint flatten(uint length) { return ::flattenL(P, length); }
+};
+
+class ufSplitting : public equivalenceSolver<ufSplitting> {
+public:
+	explicit ufSplitting(size_t length) : equivalenceSolver(length) {}
+
+	// Every node of the path is linked to its grandparent
+	uint root(uint i) {
+		while (P[i] < i){
+			COUNT_EVENT(CT_FINDROOT_STEPS);
+			const uint parent = P[i];
+			P[i] = P[parent];
+			i = parent;
+		}
+		return i;
+	}
+
+	uint merge(uint i, uint j) {
+		const uint rooti = root(i), rootj = root(j);
+		if (rooti < rootj){
+			P[rootj] = rooti;
+			return rooti;
+		}
+		P[rooti] = rootj;
+		return rootj;
+	}
+
+	uint flatten(uint length) { return ::flattenL(P, length); }
+};
+
+// Root search and flattening of the solvers which link by a weight of the trees, so that roots may be larger 
+// than the other labels of their set
+template <typename SolverT>
+class ufWeighted : public equivalenceSolver<SolverT> {
+public:
+	explicit ufWeighted(size_t length) : equivalenceSolver<SolverT>(length) {}
+
+	// Roots point to themselves
+	uint root(uint i) {
+		uint * const P = this->P;
+		uint root = i;
+		while (P[root] != root){
+			COUNT_EVENT(CT_FINDROOT_STEPS);
+			root = P[root];
+		}
+		while (P[i] != root){
+			const uint parent = P[i];
+			P[i] = root;
+			i = parent;
+		}
+		return root;
+	}
+
+	// All the labels are linked to their root first, then sets are numbered in order of their smallest label
+	uint flatten(uint length) {
+		uint * const P = this->P;
+		for (uint i = 1; i < length; ++i)
+			P[i] = root(i);
+		std::vector<uint> final_labels(length, 0);
+		uint k = 1;
+		for (uint i = 1; i < length; ++i){
+			uint& label = final_labels[P[i]];
+			if (label == 0)
+				label = k++;
+			P[i] = label;
+		}
+		return k;
+	}
+};
+
+class ufRank : public ufWeighted<ufRank> {
+public:
+	explicit ufRank(size_t length) : ufWeighted(length), rank(length, 0) {}
+
+	uint merge(uint i, uint j) {
+		uint rooti = root(i), rootj = root(j);
+		if (rooti == rootj)
+			return rooti;
+		if (rank[rooti] < rank[rootj])
+			std::swap(rooti, rootj);
+		P[rootj] = rooti;
+		if (rank[rooti] == rank[rootj])
+			rank[rooti]++;
+		return rooti;
+	}
+
+private:
+	std::vector<uchar> rank;
+};
+
+class ufSize : public ufWeighted<ufSize> {
+public:
+	explicit ufSize(size_t length) : ufWeighted(length), size(length, 1) {}
+
+	// The root of the set with fewer labels is linked to the other one (to the root of i on ties, as in ufRank)
+	uint merge(uint i, uint j) {
+		uint rooti = root(i), rootj = root(j);
+		if (rooti == rootj)
+			return rooti;
+		if (size[rooti] < size[rootj])
+			std::swap(rooti, rootj);
+		P[rootj] = rooti;
+		size[rooti] += size[rootj];
+		return rooti;
+	}
+
+private:
+	std::vector<uint> size;
+};
+
+class ufRem : public equivalenceSolver<ufRem> {
+public:
+	explicit ufRem(size_t length) : equivalenceSolver(length) {}
+
+	// The two paths are climbed together, always from the node with the larger parent, which is spliced onto the 
+	// other path: the sets are merged as soon as a root is reached, without finding the other root.
+	uint merge(uint i, uint j) {
+		while (P[i] != P[j]){
+			COUNT_EVENT(CT_FINDROOT_STEPS);
+			if (P[i] > P[j]){
+				if (P[i] == i){
+					P[i] = P[j];
+					return P[j];
+				}
+				const uint parent = P[i];
+				P[i] = P[j];
+				i = parent;
+			}
+			else{
+				if (P[j] == j){
+					P[j] = P[i];
+					return P[i];
+				}
+				const uint parent = P[j];
+				P[j] = P[i];
+				j = parent;
+			}
+		}
+		return P[i];
+	}
+
+	uint flatten(uint length) { return ::flattenL(P, length); }
+};
+
+class ufLists : public equivalenceSolver<ufLists> {
+public:
+	explicit ufLists(size_t length) : equivalenceSolver(length), next(length, 0), tail(length) {
+		for (size_t i = 0; i < length; ++i)
+			tail[i] = (uint)i;
+	}
+
+	// P holds the representative (smallest label) of every set, and the labels of a set are listed in next, from 
+	// the representative to tail[representative] (0 ends the list, since it is never in a set)
+	uint merge(uint i, uint j) {
+		uint u = P[i], v = P[j];
+		if (u == v)
+			return u;
+		if (u > v)
+			std::swap(u, v);
+		for (uint k = v; k != 0; k = next[k]){
+			COUNT_EVENT(CT_RELINK_STEPS);
+			P[k] = u;
+		}
+		next[tail[u]] = v;
+		tail[u] = tail[v];
+		return u;
+	}
+
+	uint flatten(uint length) { return ::flattenL(P, length); }
+
+private:
+	std::vector<uint> next;
+	std::vector<uint> tail;
+};
+
+// A quick and dirty upper bound for the maximum number of provisional labels of a rows x cols image: one for 
+// every 2x2 block, plus background
+inline size_t blockLabelsBound(int rows, int cols){
+	return ((size_t)rows + 1) / 2 * (((size_t)cols + 1) / 2) + 1;
+}
+
+// Labeling scheme shared by the engines which create at most one provisional label for every 2x2 block (BBDT_OPT, 
+// CTB_OPT and their variants), on the equivalences P (room for blockLabelsBound labels): firstScan(P, lunique) 
+// creates provisional labels from lunique on, P is flattened, and secondScan(P, lunique, nLabel) produces the 
+// output from the final labels. Returns what secondScan returns, which is nLabel (background included) unless 
+// components are filtered.
+template <typename EquivalencesT, typename FirstScanT, typename SecondScanT>
+inline
+int labelBlocks(EquivalencesT &P, FirstScanT firstScan, SecondScanT secondScan){
+	//Background
+	P[0] = 0;
+	uint lunique = 1;
+
+	firstScan(P, lunique);
+	COUNT_EVENTS(CT_PROVISIONAL_LABELS, lunique - 1);
+
+	uint nLabel = flattenL(P, lunique);
+
+	return secondScan(P, lunique, nLabel);
+}
+
+// labelBlocks with the equivalences solved by SolverT
+template <typename SolverT, typename FirstScanT, typename SecondScanT>
+inline
+int labelBlocks(int rows, int cols, FirstScanT firstScan, SecondScanT secondScan){
+	//Tree of labels
+	SolverT P(blockLabelsBound(rows, cols));
+	return labelBlocks(P, firstScan, secondScan);
+}
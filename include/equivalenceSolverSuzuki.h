@@ -29,6 +29,7 @@
 #pragma once
 #include <vector>
 #include "memoryTester.h"
+#include "labelingCounters.h"
 
 // "STANDARD" VERSION
 //Find the root of the tree of node i
@@ -38,6 +39,7 @@ LabelT findRoot(const LabelT *P, LabelT i){
 	LabelT root = i;
 	while (P[root] < root){
 		root = P[root];
+		COUNT_EVENT(CT_FINDROOT_STEPS);
 	}
 	return root;
 }
@@ -67,6 +69,7 @@ LabelT find(LabelT *P, LabelT i){
 template<typename LabelT>
 inline static
 LabelT set_union(LabelT *P, LabelT i, LabelT j){
+	COUNT_EVENT(CT_UNIONS);
 	LabelT root = findRoot(P, i);
 	if (i != j){
 		LabelT rootj = findRoot(P, j);
@@ -98,10 +101,11 @@ LabelT flattenL(LabelT *P, LabelT length){
 
 
 // "MEMORY TEST" VERSION
+// Labels are not deduced from the arguments, which may be memRef to elements of memVector or memMat
 //Find the root of the tree of node i
 template<typename LabelT>
 inline static
-LabelT findRoot(memVector<LabelT> &P, LabelT i){
+LabelT findRoot(memVector<LabelT> &P, typename memVector<LabelT>::value_type i){
 	LabelT root = i;
 	while (P[root] < root){
 		root = P[root];
@@ -112,7 +116,7 @@ LabelT findRoot(memVector<LabelT> &P, LabelT i){
 //Make all nodes in the path of node i point to root
 template<typename LabelT>
 inline static
-void setRoot(memVector<LabelT> &P, LabelT i, LabelT root){
+void setRoot(memVector<LabelT> &P, typename memVector<LabelT>::value_type i, typename memVector<LabelT>::value_type root){
 	while (P[i] < i){
 		LabelT j = P[i];
 		P[i] = root;
@@ -124,7 +128,7 @@ void setRoot(memVector<LabelT> &P, LabelT i, LabelT root){
 //Find the root of the tree of the node i and compress the path in the process
 template<typename LabelT>
 inline static
-LabelT find(memVector<LabelT> &P, LabelT i){
+LabelT find(memVector<LabelT> &P, typename memVector<LabelT>::value_type i){
 	LabelT root = findRoot(P, i);
 	setRoot(P, i, root);
 	return root;
@@ -133,7 +137,7 @@ LabelT find(memVector<LabelT> &P, LabelT i){
 //unite the two trees containing nodes i and j and return the new root
 template<typename LabelT>
 inline static
-LabelT set_union(memVector<LabelT> &P, LabelT i, LabelT j){
+LabelT set_union(memVector<LabelT> &P, typename memVector<LabelT>::value_type i, typename memVector<LabelT>::value_type j){
 	LabelT root = findRoot(P, i);
 	if (i != j){
 		LabelT rootj = findRoot(P, j);
@@ -149,7 +153,7 @@ LabelT set_union(memVector<LabelT> &P, LabelT i, LabelT j){
 //Flatten the Union Find tree and relabel the components
 template<typename LabelT>
 inline static
-LabelT flattenL(memVector<LabelT> &P, LabelT length){
+LabelT flattenL(memVector<LabelT> &P, typename memVector<LabelT>::value_type length){
 	LabelT k = 1;
 	for (LabelT i = 1; i < length; ++i){
 		if (P[i] < i){
@@ -0,0 +1,182 @@
+// Copyright(c) 2016 - Costantino Grana, Federico Bolelli, Lorenzo Baraldi and Roberto Vezzani
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// *Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+// 
+// * Neither the name of YACCLAB nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "goldenLabels.h"
+
+#include <climits>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#if !defined(YACCLAB_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define LABELS_SSE2
+#include <emmintrin.h>
+#endif
+
+using namespace cv;
+using namespace std;
+
+static const uint64_t kFnvOffset = 14695981039346656037ull;
+static const uint64_t kFnvPrime = 1099511628211ull;
+
+static inline uint64_t fnv1a(uint64_t hash, uint32_t value){
+	for (int b = 0; b < 4; ++b){
+		hash ^= (value >> (8 * b)) & 0xFF;
+		hash *= kFnvPrime;
+	}
+	return hash;
+}
+
+uint64_t binaryImageHash(const Mat1b& img){
+	uint64_t hash = fnv1a(fnv1a(kFnvOffset, img.rows), img.cols);
+	for (int r = 0; r < img.rows; ++r){
+		const uchar * const img_row = img.ptr<uchar>(r);
+		for (int c = 0; c < img.cols; ++c){
+			hash ^= img_row[c];
+			hash *= kFnvPrime;
+		}
+	}
+	return hash;
+}
+
+uint64_t labelsHash(const Mat1i& labels){
+
+	// Labels are remapped with a table instead of a map: the first pass finds the greatest label
+	uint maxLabel = 0;
+	for (int r = 0; r < labels.rows; ++r){
+		const uint * const labels_row = labels.ptr<uint>(r);
+		for (int c = 0; c < labels.cols; ++c)
+			maxLabel = max(maxLabel, labels_row[c]);
+	}
+
+	vector<uint> newLabels((size_t)maxLabel + 1, 0);
+	uint maxNewLabel = 0;
+	uint64_t hash = fnv1a(fnv1a(kFnvOffset, labels.rows), labels.cols);
+	for (int r = 0; r < labels.rows; ++r){
+		const uint * const labels_row = labels.ptr<uint>(r);
+		for (int c = 0; c < labels.cols; ++c){
+			const uint label = labels_row[c];
+			if (label > 0 && newLabels[label] == 0)
+				newLabels[label] = ++maxNewLabel;
+			hash = fnv1a(hash, newLabels[label]);
+		}
+	}
+	return hash;
+}
+
+bool equivalentLabels(const Mat1i& a, unsigned a_labels, const Mat1i& b, unsigned b_labels, Point& first_diff){
+
+	first_diff = Point(-1, -1);
+	if (a.rows != b.rows || a.cols != b.cols)
+		return false;
+
+	// Labels of the other image corresponding to every label (kUnset if not seen yet)
+	const uint kUnset = UINT_MAX;
+	vector<uint> a_to_b((size_t)a_labels + 1, kUnset), b_to_a((size_t)b_labels + 1, kUnset);
+	a_to_b[0] = 0;
+	b_to_a[0] = 0;
+
+	for (int r = 0; r < a.rows; ++r){
+		const uint * const a_row = a.ptr<uint>(r);
+		const uint * const b_row = b.ptr<uint>(r);
+
+		// Last checked pair, background is always consistent
+		uint la = 0, lb = 0;
+		for (int c = 0; c < a.cols;){
+#ifdef LABELS_SSE2
+			if (c + 4 <= a.cols){
+				const __m128i eq_a = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(a_row + c)), _mm_set1_epi32((int)la));
+				const __m128i eq_b = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(b_row + c)), _mm_set1_epi32((int)lb));
+				if (_mm_movemask_epi8(_mm_and_si128(eq_a, eq_b)) == 0xFFFF){
+					c += 4;
+					continue;
+				}
+			}
+			const int end = min(c + 4, a.cols);
+#else
+			const int end = c + 1;
+#endif
+			for (; c < end; ++c){
+				const uint ca = a_row[c], cb = b_row[c];
+				if (ca == la && cb == lb)
+					continue;
+				if (ca >= a_to_b.size())
+					a_to_b.resize((size_t)ca + 1, kUnset);
+				if (cb >= b_to_a.size())
+					b_to_a.resize((size_t)cb + 1, kUnset);
+				if (a_to_b[ca] == kUnset && b_to_a[cb] == kUnset){
+					a_to_b[ca] = cb;
+					b_to_a[cb] = ca;
+				}
+				else if (a_to_b[ca] != cb || b_to_a[cb] != ca){
+					first_diff = Point(c, r);
+					return false;
+				}
+				la = ca;
+				lb = cb;
+			}
+		}
+	}
+	return true;
+}
+
+// File format (tab separated): file name, image hash, labels hash (hexadecimal), number of labels
+bool loadGoldenLabels(const string& path, map<string, goldenLabels>& golden){
+
+	ifstream is(path);
+	if (!is.is_open())
+		return false;
+
+	string line;
+	while (getline(is, line)){
+		if (line.empty() || line[0] == '#')
+			continue;
+		stringstream ss(line);
+		string filename, image_hash, labels_hash, n_labels;
+		if (!getline(ss, filename, '\t') || !getline(ss, image_hash, '\t') || !getline(ss, labels_hash, '\t') || !getline(ss, n_labels))
+			continue;
+		goldenLabels entry;
+		entry.image_hash = stoull(image_hash, nullptr, 16);
+		entry.labels_hash = stoull(labels_hash, nullptr, 16);
+		entry.n_labels = (unsigned)stoul(n_labels);
+		golden[filename] = entry;
+	}
+	return true;
+}
+
+bool saveGoldenLabels(const string& path, const map<string, goldenLabels>& golden){
+
+	ofstream os(path);
+	if (!os.is_open())
+		return false;
+
+	os << "# file\timage hash\tlabels hash\tlabels" << endl;
+	for (auto it = golden.begin(); it != golden.end(); ++it)
+		os << it->first << "\t" << hex << it->second.image_hash << "\t" << it->second.labels_hash << "\t" << dec << it->second.n_labels << endl;
+	return true;
+}
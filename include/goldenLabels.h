@@ -0,0 +1,64 @@
+// Copyright(c) 2016 - Costantino Grana, Federico Bolelli, Lorenzo Baraldi and Roberto Vezzani
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// *Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+// 
+// * Neither the name of YACCLAB nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include "opencv2/opencv.hpp"
+#include <cstdint>
+#include <map>
+#include <string>
+
+// Reference results of the correctness check on an image: the hash of the normalized reference 
+// labeling and its number of labels, together with the hash of the binary image they refer to, 
+// so that results of images which have been changed are not trusted.
+struct goldenLabels{
+	uint64_t image_hash;
+	uint64_t labels_hash;
+	unsigned n_labels;
+};
+
+// FNV-1a hash of a binary image (size included)
+uint64_t binaryImageHash(const cv::Mat1b& img);
+
+// FNV-1a hash of a label image normalized in row major order (labels numbered in order of first 
+// appearance), so that labelings of the same components with different labels have the same hash. 
+// The image is not modified.
+uint64_t labelsHash(const cv::Mat1i& labels);
+
+// Check that two label images describe the same components: there must be a bijection between their labels 
+// which maps background to background. One pass with lookup tables sized by the number of labels (grown if 
+// larger labels are found), stopping at the first mismatch. If they are not equivalent 'first_diff' is set to 
+// the first pixel (in row major order) on which the bijection is broken, to (-1, -1) if sizes differ. 
+// Runs of pixels equal to the last checked pair are skipped four at a time with SSE2, when available 
+// (define YACCLAB_NO_SIMD to disable it).
+bool equivalentLabels(const cv::Mat1i& a, unsigned a_labels, const cv::Mat1i& b, unsigned b_labels, cv::Point& first_diff);
+
+// Load the golden results of a dataset (file name -> results). false if the file does not exist.
+bool loadGoldenLabels(const std::string& path, std::map<std::string, goldenLabels>& golden);
+
+// Store the golden results of a dataset
+bool saveGoldenLabels(const std::string& path, const std::map<std::string, goldenLabels>& golden);
@@ -0,0 +1,227 @@
+// Copyright(c) 2016 - Costantino Grana, Federico Bolelli, Lorenzo Baraldi and Roberto Vezzani
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// *Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+// 
+// * Neither the name of YACCLAB nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "imageGenerator.h"
+
+#include <cmath>
+
+using namespace cv;
+using namespace std;
+
+static const char* const texturesNames[TX_SIZE] = { "random", "blobs", "stripes", "spiral", "granular", "comb", "reverse_comb", "staircase" };
+
+string textureName(texturetype texture){
+	return texturesNames[texture];
+}
+
+bool textureFromName(const string &name, texturetype &texture){
+	for (int t = 0; t < TX_SIZE; ++t){
+		if (name == texturesNames[t]){
+			texture = (texturetype)t;
+			return true;
+		}
+	}
+	return false;
+}
+
+vector<string> textureNames(bool pathological){
+	vector<string> names;
+	for (int t = pathological ? TX_FIRST_PATHOLOGICAL : 0; t < (pathological ? TX_SIZE : TX_FIRST_PATHOLOGICAL); ++t)
+		names.push_back(texturesNames[t]);
+	return names;
+}
+
+// Every pixel is independent: compare a 32 bit random number with the density scaled to 2^32
+static void randomNoise(Mat1b &img, double density, RNG &rng){
+	const uint64_t threshold = (uint64_t)(density * 4294967296.0);
+	for (int r = 0; r < img.rows; ++r){
+		uchar* const img_row = img.ptr<uchar>(r);
+		for (int c = 0; c < img.cols; ++c){
+			img_row[c] = (uint64_t)(unsigned)rng < threshold;
+		}
+	}
+}
+
+// Smooth noise is obtained from a coarse grid of random values (one every 'cell' pixels) bilinearly 
+// interpolated on the fly, so that no full resolution floating point image has to be stored. The 
+// threshold which gives the requested density is computed from the histogram of the interpolated values.
+static void smoothNoise(Mat1b &img, double density, int cell, RNG &rng){
+
+	const int grid_rows = img.rows / cell + 2, grid_cols = img.cols / cell + 2;
+	Mat1f grid(grid_rows, grid_cols);
+	for (int r = 0; r < grid_rows; ++r){
+		for (int c = 0; c < grid_cols; ++c){
+			grid(r, c) = rng.uniform(0.f, 1.f);
+		}
+	}
+
+	const int bins = 4096;
+	const float inv_cell = 1.f / cell;
+
+	// Interpolated value of pixel (r,c), in [0,1)
+#define interpolated_value (((1 - fy) * ((1 - fx) * grid_row[gx] + fx * grid_row[gx + 1]) + fy * ((1 - fx) * grid_row_fol[gx] + fx * grid_row_fol[gx + 1])))
+
+	// First pass: histogram of values
+	vector<uint64_t> histogram(bins, 0);
+	for (int r = 0; r < img.rows; ++r){
+		const int gy = r / cell;
+		const float fy = (r - gy * cell) * inv_cell;
+		const float* const grid_row = grid.ptr<float>(gy);
+		const float* const grid_row_fol = grid.ptr<float>(gy + 1);
+		for (int c = 0; c < img.cols; ++c){
+			const int gx = c / cell;
+			const float fx = (c - gx * cell) * inv_cell;
+			histogram[min(bins - 1, (int)(interpolated_value * bins))]++;
+		}
+	}
+
+	// Highest values become foreground
+	const uint64_t foreground = (uint64_t)(density * img.rows * img.cols);
+	uint64_t count = 0;
+	int threshold = bins;
+	while (threshold > 0 && count + histogram[threshold - 1] <= foreground){
+		count += histogram[--threshold];
+	}
+
+	// Second pass: thresholding
+	for (int r = 0; r < img.rows; ++r){
+		const int gy = r / cell;
+		const float fy = (r - gy * cell) * inv_cell;
+		const float* const grid_row = grid.ptr<float>(gy);
+		const float* const grid_row_fol = grid.ptr<float>(gy + 1);
+		uchar* const img_row = img.ptr<uchar>(r);
+		for (int c = 0; c < img.cols; ++c){
+			const int gx = c / cell;
+			const float fx = (c - gx * cell) * inv_cell;
+			img_row[c] = min(bins - 1, (int)(interpolated_value * bins)) >= threshold;
+		}
+	}
+
+#undef interpolated_value
+}
+
+// Stripes orthogonal to a random direction among horizontal, vertical and the two diagonals
+static void stripes(Mat1b &img, double density, RNG &rng){
+	static const int directions[4][2] = { { 1, 0 }, { 0, 1 }, { 1, 1 }, { 1, -1 } };
+	const int *d = directions[rng.uniform(0, 4)];
+	const int period = rng.uniform(4, 33);
+	const int width = (int)std::round(density * period);
+	const int offset = period * (img.rows + img.cols); // To keep the modulus argument positive
+	for (int r = 0; r < img.rows; ++r){
+		uchar* const img_row = img.ptr<uchar>(r);
+		for (int c = 0; c < img.cols; ++c){
+			img_row[c] = (d[0] * r + d[1] * c + offset) % period < width;
+		}
+	}
+}
+
+// A single Archimedean spiral arm whose width (with respect to the pitch) is equal to density
+static void spiral(Mat1b &img, double density, RNG &rng){
+	const double pitch = rng.uniform(8., 64.);
+	const double phase = rng.uniform(0., 1.);
+	const double cy = img.rows / 2.0, cx = img.cols / 2.0;
+	const double inv_2pi = 1.0 / (2.0 * CV_PI);
+	for (int r = 0; r < img.rows; ++r){
+		uchar* const img_row = img.ptr<uchar>(r);
+		const double y = r - cy;
+		for (int c = 0; c < img.cols; ++c){
+			const double x = c - cx;
+			double t = sqrt(x * x + y * y) / pitch - atan2(y, x) * inv_2pi + phase;
+			t -= floor(t);
+			img_row[c] = t < density;
+		}
+	}
+}
+
+// Teeth on even columns, joined by the last row
+static void comb(Mat1b &img){
+	for (int r = 0; r < img.rows; ++r){
+		uchar* const img_row = img.ptr<uchar>(r);
+		for (int c = 0; c < img.cols; ++c){
+			img_row[c] = (c % 2 == 0) || (r == img.rows - 1);
+		}
+	}
+}
+
+// Full height teeth every four columns crossed by a diagonal line which starts at the top right corner and goes 
+// down-left two columns every row. Teeth are labeled left to right, the diagonal meets them right to left.
+static void reverseComb(Mat1b &img){
+	for (int r = 0; r < img.rows; ++r){
+		uchar* const img_row = img.ptr<uchar>(r);
+		const int diagonal = img.cols - 1 - 2 * r;
+		for (int c = 0; c < img.cols; ++c){
+			img_row[c] = (c % 4 == 0) || c == diagonal || c == diagonal + 1;
+		}
+	}
+}
+
+// Teeth every four columns with 4 pixels wide treads on odd rows, shifted by one tooth every two rows so that 
+// they climb like staircases: every tread merges two teeth, which gives one union every few pixels 
+static void staircase(Mat1b &img){
+	for (int r = 0; r < img.rows; ++r){
+		uchar* const img_row = img.ptr<uchar>(r);
+		for (int c = 0; c < img.cols; ++c){
+			img_row[c] = (c % 4 == 0) || (r % 2 == 1 && (c / 4 + r / 2) % 2 == 0);
+		}
+	}
+}
+
+void generateImage(texturetype texture, int rows, int cols, double density, unsigned long long seed, Mat1b &img){
+
+	img = Mat1b(rows, cols);
+	RNG rng((uint64)seed);
+
+	switch (texture){
+	case(TX_RANDOM_NOISE) :
+		randomNoise(img, density, rng);
+		break;
+	case(TX_BLOBS) :
+		smoothNoise(img, density, max(8, min(rows, cols) / 16), rng);
+		break;
+	case(TX_STRIPES) :
+		stripes(img, density, rng);
+		break;
+	case(TX_SPIRAL) :
+		spiral(img, density, rng);
+		break;
+	case(TX_GRANULAR) :
+		smoothNoise(img, density, 3, rng);
+		break;
+	case(TX_COMB) :
+		comb(img);
+		break;
+	case(TX_REVERSE_COMB) :
+		reverseComb(img);
+		break;
+	case(TX_STAIRCASE) :
+		staircase(img);
+		break;
+	default:
+		img = Mat1b(rows, cols, (uchar)0);
+	}
+}
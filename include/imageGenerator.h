@@ -0,0 +1,68 @@
+// Copyright(c) 2016 - Costantino Grana, Federico Bolelli, Lorenzo Baraldi and Roberto Vezzani
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// *Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+// 
+// * Neither the name of YACCLAB nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include "opencv2/opencv.hpp"
+#include <string>
+#include <vector>
+
+// Textures produced by the synthetic image generator
+enum texturetype{
+	TX_RANDOM_NOISE = 0,	// Independent pixels, foreground with probability equal to density 
+	TX_BLOBS = 1,			// Large smooth blobs (thresholded low frequency noise)
+	TX_STRIPES = 2,			// Parallel stripes with random orientation and period
+	TX_SPIRAL = 3,			// Archimedean spiral arm around the image center
+	TX_GRANULAR = 4,		// Small grains (thresholded high frequency noise)
+
+	// Adversarial patterns for equivalence resolution, density is ignored
+	TX_COMB = 5,			// Vertical teeth joined by the last row: one provisional label per tooth, all merged at the end
+	TX_REVERSE_COMB = 6,	// Vertical teeth joined by a diagonal going from the top right to the bottom left corner, so that 
+							// every merge moves the representative label to an older (smaller) one
+	TX_STAIRCASE = 7,		// Teeth joined by staircases of short treads: one union every few pixels
+
+	// Total number of textures in the list
+	TX_SIZE = 8,
+};
+
+// First adversarial texture, the ones before it are "natural" textures
+#define TX_FIRST_PATHOLOGICAL TX_COMB
+
+// Return the name used in the configuration file and in the output folders for a texture
+std::string textureName(texturetype texture);
+
+// Find texture from its name, return false if the name is unknown
+bool textureFromName(const std::string &name, texturetype &texture);
+
+// Names of the natural textures (before TX_FIRST_PATHOLOGICAL) or of the adversarial ones
+std::vector<std::string> textureNames(bool pathological);
+
+// Generate a binary image (foreground = 1, background = 0) of the specified texture, size and 
+// density. The image depends only on the parameters and on the seed, so that every run of the 
+// benchmark labels exactly the same images without storing them on disk. For blobs and granular 
+// textures density is matched up to 1/4096.
+void generateImage(texturetype texture, int rows, int cols, double density, unsigned long long seed, cv::Mat1b &img);
@@ -0,0 +1,106 @@
+// Copyright(c) 2016 - Costantino Grana, Federico Bolelli, Lorenzo Baraldi and Roberto Vezzani
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// *Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+// 
+// * Neither the name of YACCLAB nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include "opencv2/opencv.hpp"
+#include <vector>
+
+// Run of pixels of a row with the same (non zero) label
+struct labelRun{
+	int start;			// Column of the first pixel
+	int length;
+	unsigned label;
+};
+
+// Run of foreground pixels of a row of a binary image
+struct binaryRun{
+	int start;			// Column of the first pixel
+	int length;
+};
+
+// Binary image stored as runs of foreground pixels (e.g. decoded from a CCITT G4 page), with the same 
+// layout of labelRuns. Runs of a row must be sorted by start and must not overlap.
+struct binaryRuns{
+	int rows = 0;
+	int cols = 0;
+	std::vector<binaryRun> runs;
+	std::vector<size_t> row_begin;	// rows + 1 elements
+
+	// Runs of a binary image (pixels greater than 0 are foreground)
+	void encode(const cv::Mat1b& img){
+		rows = img.rows;
+		cols = img.cols;
+		runs.clear();
+		row_begin.assign(1, 0);
+		for (int r = 0; r < rows; ++r){
+			const uchar * const img_row = img.ptr<uchar>(r);
+			for (int c = 0; c < cols; ++c){
+				if (img_row[c] > 0){
+					const int start = c;
+					while (c + 1 < cols && img_row[c + 1] > 0)
+						++c;
+					runs.push_back({ start, c - start + 1 });
+				}
+			}
+			row_begin.push_back(runs.size());
+		}
+	}
+};
+
+// Label image stored as runs of foreground pixels, for sparse images (e.g. documents) where most of 
+// the pixels are background. Runs of row r are runs[row_begin[r]] ... runs[row_begin[r + 1] - 1], in 
+// increasing order of start, and background pixels are not stored at all.
+struct labelRuns{
+	int rows = 0;
+	int cols = 0;
+	std::vector<labelRun> runs;
+	std::vector<size_t> row_begin;	// rows + 1 elements
+
+	// Prepare for a new image, keeping the allocated memory
+	void reset(int image_rows, int image_cols){
+		rows = image_rows;
+		cols = image_cols;
+		runs.clear();
+		row_begin.assign(1, 0);
+	}
+
+	// Close the current row: following runs belong to the next one
+	void endRow(){
+		row_begin.push_back(runs.size());
+	}
+
+	// Dense label image
+	void toDense(cv::Mat1i& imgLabels) const{
+		imgLabels = cv::Mat1i(rows, cols, 0);
+		for (int r = 0; r < rows; ++r){
+			unsigned * const imgLabels_row = imgLabels.ptr<unsigned>(r);
+			for (size_t i = row_begin[r]; i < row_begin[r + 1]; ++i)
+				std::fill(imgLabels_row + runs[i].start, imgLabels_row + runs[i].start + runs[i].length, runs[i].label);
+		}
+	}
+};
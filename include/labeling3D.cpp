@@ -0,0 +1,226 @@
+// Copyright(c) 2016 - Costantino Grana, Federico Bolelli, Lorenzo Baraldi and Roberto Vezzani
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// *Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+// 
+// * Neither the name of YACCLAB nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "labeling3D.h"
+#include "equivalenceSolverSuzuki.h"
+
+using namespace cv;
+using namespace std;
+
+// Voxels of a 2x2x2 block are the bits of a mask: bit z * 4 + r * 2 + c is the voxel in slice z, row r and 
+// column c of the block.
+inline static
+uchar blockMask(const vector<Mat1b> &volume, int z, int r, int c) {
+	const int d = (int)volume.size(), h = volume[0].rows, w = volume[0].cols;
+	uchar mask = 0;
+	for (int bz = 0; bz < 2 && z + bz < d; ++bz) {
+		for (int br = 0; br < 2 && r + br < h; ++br) {
+			const uchar * const volume_row = volume[z + bz].ptr<uchar>(r + br);
+			for (int bc = 0; bc < 2 && c + bc < w; ++bc) {
+				if (volume_row[c + bc] > 0)
+					mask |= 1 << (bz * 4 + br * 2 + bc);
+			}
+		}
+	}
+	return mask;
+}
+
+// The 13 blocks which precede a block in the scan (offsets in blocks), and the table used in place of the decision 
+// tree: adjacent[n][mask] is the mask of the voxels of the n-th preceding block which are 26-connected with the 
+// voxels of 'mask'. Two blocks are connected if this and the mask of the other block have a common voxel.
+static const int prev_blocks[13][3] = {
+	{ -1, -1, -1 }, { -1, -1, 0 }, { -1, -1, 1 },
+	{ -1, 0, -1 }, { -1, 0, 0 }, { -1, 0, 1 },
+	{ -1, 1, -1 }, { -1, 1, 0 }, { -1, 1, 1 },
+	{ 0, -1, -1 }, { 0, -1, 0 }, { 0, -1, 1 },
+	{ 0, 0, -1 }
+};
+
+struct blockAdjacency {
+	uchar adjacent[13][256];
+
+	blockAdjacency() {
+		for (int n = 0; n < 13; ++n) {
+			uchar voxel[8] = {}; // Voxels of the other block adjacent to every voxel of the block
+			for (int i = 0; i < 8; ++i) {
+				for (int j = 0; j < 8; ++j) {
+					const int dz = 2 * prev_blocks[n][0] + (j >> 2) - (i >> 2);
+					const int dr = 2 * prev_blocks[n][1] + ((j >> 1) & 1) - ((i >> 1) & 1);
+					const int dc = 2 * prev_blocks[n][2] + (j & 1) - (i & 1);
+					if (abs(dz) <= 1 && abs(dr) <= 1 && abs(dc) <= 1)
+						voxel[i] |= 1 << j;
+				}
+			}
+			for (int mask = 0; mask < 256; ++mask) {
+				adjacent[n][mask] = 0;
+				for (int i = 0; i < 8; ++i) {
+					if (mask & (1 << i))
+						adjacent[n][mask] |= voxel[i];
+				}
+			}
+		}
+	}
+};
+
+int BBDT_3D(const vector<Mat1b> &volume, vector<Mat1i> &volLabels) {
+	static const blockAdjacency adjacency;
+
+	volLabels.clear();
+	if (volume.empty())
+		return 1;
+	const int d = (int)volume.size(), h = volume[0].rows, w = volume[0].cols;
+	const int bd = (d + 1) / 2, bh = (h + 1) / 2, bw = (w + 1) / 2;
+	const size_t blocks = (size_t)bd * bh * bw;
+
+	// Masks and provisional labels of the blocks
+	vector<uchar> masks(blocks);
+	vector<uint> labels(blocks);
+	//Every block may have its own label
+	const size_t Plength = blocks + 1;
+	//Tree of labels
+	uint *P = (uint *)fastMalloc(sizeof(uint)* Plength);
+	//Background
+	P[0] = 0;
+	uint lunique = 1;
+
+	// First scan
+	size_t b = 0;
+	for (int z = 0; z < bd; ++z) {
+		for (int r = 0; r < bh; ++r) {
+			for (int c = 0; c < bw; ++c, ++b) {
+				const uchar mask = blockMask(volume, z * 2, r * 2, c * 2);
+				masks[b] = mask;
+				uint label = 0;
+				if (mask) {
+					for (int n = 0; n < 13; ++n) {
+						const int nz = z + prev_blocks[n][0], nr = r + prev_blocks[n][1], nc = c + prev_blocks[n][2];
+						if (nz < 0 || nr < 0 || nr >= bh || nc < 0 || nc >= bw)
+							continue;
+						const size_t nb = ((size_t)nz * bh + nr) * bw + nc;
+						if (labels[nb] == 0 || labels[nb] == label || (adjacency.adjacent[n][mask] & masks[nb]) == 0)
+							continue;
+						label = label ? set_union(P, label, labels[nb]) : labels[nb];
+					}
+					if (!label) {
+						// New label
+						P[lunique] = lunique;
+						label = lunique++;
+					}
+				}
+				labels[b] = label;
+			}
+		}
+	}
+	COUNT_EVENTS(CT_PROVISIONAL_LABELS, lunique - 1);
+
+	uint nLabel = flattenL(P, lunique);
+
+	// Second scan
+	volLabels.resize(d);
+	for (int z = 0; z < d; ++z) {
+		volLabels[z] = Mat1i(h, w);
+		const size_t slice_blocks = (size_t)(z / 2) * bh * bw;
+		for (int r = 0; r < h; ++r) {
+			const uchar * const volume_row = volume[z].ptr<uchar>(r);
+			uint * const volLabels_row = volLabels[z].ptr<uint>(r);
+			const uint * const labels_row = labels.data() + slice_blocks + (size_t)(r / 2) * bw;
+			for (int c = 0; c < w; ++c)
+				volLabels_row[c] = volume_row[c] > 0 ? P[labels_row[c >> 1]] : 0;
+		}
+	}
+
+	fastFree(P);
+	return nLabel;
+}
+
+int VOXEL_3D_6(const vector<Mat1b> &volume, vector<Mat1i> &volLabels) {
+
+	volLabels.clear();
+	if (volume.empty())
+		return 1;
+	const int d = (int)volume.size(), h = volume[0].rows, w = volume[0].cols;
+
+	//Voxels with a new label are never 6-connected, so they are at most half of the voxels
+	const size_t Plength = ((size_t)d * h * w + 1) / 2 + 1;
+	//Tree of labels
+	uint *P = (uint *)fastMalloc(sizeof(uint)* Plength);
+	//Background
+	P[0] = 0;
+	uint lunique = 1;
+
+	// First scan: the provisional labels are stored in the output
+	volLabels.resize(d);
+	for (int z = 0; z < d; ++z) {
+		volLabels[z] = Mat1i(h, w);
+		for (int r = 0; r < h; ++r) {
+			const uchar * const volume_row = volume[z].ptr<uchar>(r);
+			uint * const volLabels_row = volLabels[z].ptr<uint>(r);
+			const uint * const volLabels_row_prev = r > 0 ? volLabels[z].ptr<uint>(r - 1) : nullptr;
+			const uint * const volLabels_slice_prev = z > 0 ? volLabels[z - 1].ptr<uint>(r) : nullptr;
+			for (int c = 0; c < w; ++c) {
+				uint label = 0;
+				if (volume_row[c] > 0) {
+					if (z > 0 && volLabels_slice_prev[c])
+						label = volLabels_slice_prev[c];
+					if (r > 0 && volLabels_row_prev[c] && volLabels_row_prev[c] != label)
+						label = label ? set_union(P, label, volLabels_row_prev[c]) : volLabels_row_prev[c];
+					if (c > 0 && volLabels_row[c - 1] && volLabels_row[c - 1] != label)
+						label = label ? set_union(P, label, volLabels_row[c - 1]) : volLabels_row[c - 1];
+					if (!label) {
+						// New label
+						P[lunique] = lunique;
+						label = lunique++;
+					}
+				}
+				volLabels_row[c] = label;
+			}
+		}
+	}
+	COUNT_EVENTS(CT_PROVISIONAL_LABELS, lunique - 1);
+
+	uint nLabel = flattenL(P, lunique);
+
+	// Second scan
+	for (int z = 0; z < d; ++z) {
+		for (int r = 0; r < h; ++r) {
+			uint * const volLabels_row = volLabels[z].ptr<uint>(r);
+			for (int c = 0; c < w; ++c)
+				volLabels_row[c] = P[volLabels_row[c]];
+		}
+	}
+
+	fastFree(P);
+	return nLabel;
+}
+
+int BBDT_3D_SLICE(const Mat1b &img, Mat1i &imgLabels) {
+	vector<Mat1i> volLabels;
+	const int nLabel = BBDT_3D(vector<Mat1b>(1, img), volLabels);
+	imgLabels = volLabels[0];
+	return nLabel;
+}
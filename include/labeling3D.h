@@ -0,0 +1,48 @@
+// Copyright(c) 2016 - Costantino Grana, Federico Bolelli, Lorenzo Baraldi and Roberto Vezzani
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// *Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+// 
+// * Neither the name of YACCLAB nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include "opencv2/opencv.hpp"
+#include <vector>
+
+// Volumes are given as a sequence of slices (e.g. the slices of a CT/MRI mask), which must all have the same 
+// size. Voxels greater than 0 are foreground. Labels are written in a new sequence of slices, consecutive and 
+// starting from 1.
+
+// Extension of Grana's algorithm to volumes with 26-connectivity: voxels are grouped in 2x2x2 blocks, which are 
+// scanned a pair of slices and a pair of rows at a time. Every block is compared with the 13 blocks which precede 
+// it, in the same or in the previous pair of slices.
+int BBDT_3D(const std::vector<cv::Mat1b> &volume, std::vector<cv::Mat1i> &volLabels);
+
+// Two scan labeling of volumes with 6-connectivity. Blocks cannot be used, since the voxels of a 2x2x2 block are not 
+// 6-connected with each other, so voxels are compared one at a time with the three voxels which precede them.
+int VOXEL_3D_6(const std::vector<cv::Mat1b> &volume, std::vector<cv::Mat1i> &volLabels);
+
+// BBDT_3D on a volume of the single slice 'img', where 26-connectivity is 8-connectivity, to check it with the 
+// algorithms on images
+int BBDT_3D_SLICE(const cv::Mat1b &img, cv::Mat1i &imgLabels);
@@ -0,0 +1,155 @@
+// Copyright(c) 2016 - Costantino Grana, Federico Bolelli, Lorenzo Baraldi and Roberto Vezzani
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// *Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+// 
+// * Neither the name of YACCLAB nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include "opencv2/opencv.hpp"
+#include "memoryTester.h"
+
+// Row accessors of the data structures of the engines. Engines are templates on the type of the 
+// binary image, of the label image and of the equivalence structure, and access rows only through 
+// these functions:
+//  - plain policy (cv::Mat1b, cv::Mat1i, raw arrays): rows are raw pointers, so the code compiled 
+//    for the timing tests is the same as if it used pointers directly;
+//  - counting policy (memMat, memVector): rows are memRow proxies, and every access is counted by 
+//    the memory tests.
+// Labels are accessed as unsigned values in both cases. Rows out of the image may be requested 
+// (e.g. the previous row of the first one), as long as they are never accessed.
+
+inline const uchar* imageRow(const cv::Mat1b& img, int r){
+	return img.data + (ptrdiff_t)r * (ptrdiff_t)img.step.p[0];
+}
+
+inline uint* labelsRow(cv::Mat1i& labels, int r){
+	return (uint *)(labels.data + (ptrdiff_t)r * (ptrdiff_t)labels.step.p[0]);
+}
+
+inline memRow<uchar> imageRow(memMat<uchar>& img, int r){
+	return memRow<uchar>(img, r);
+}
+
+inline memRow<int, uint> labelsRow(memMat<int>& labels, int r){
+	return memRow<int, uint>(labels, r);
+}
+
+// Binary image computed on the fly from a greyscale image, so that engines can label it without allocating and 
+// writing a thresholded copy first: a pixel is foreground if 'cmp' (cv::CMP_GT, CMP_GE, CMP_LT, CMP_LE, CMP_EQ or 
+// CMP_NE) holds between its value and 'thresh'. Every value is mapped through a table, so the comparison costs a 
+// lookup whatever it is. An unknown comparison raises cv::Exception (cv::Error::StsBadArg).
+struct thresholdImage{
+	const cv::Mat1b& img;
+	const int rows, cols;
+	uchar lut[256];
+
+	thresholdImage(const cv::Mat1b& img_, uchar thresh, int cmp) : img(img_), rows(img_.rows), cols(img_.cols) {
+		for (int v = 0; v < 256; ++v) {
+			bool foreground = false;
+			switch (cmp) {
+			case cv::CMP_GT: foreground = v > thresh; break;
+			case cv::CMP_GE: foreground = v >= thresh; break;
+			case cv::CMP_LT: foreground = v < thresh; break;
+			case cv::CMP_LE: foreground = v <= thresh; break;
+			case cv::CMP_EQ: foreground = v == thresh; break;
+			case cv::CMP_NE: foreground = v != thresh; break;
+			default: CV_Error(cv::Error::StsBadArg, "unknown comparison");
+			}
+			lut[v] = foreground ? 1 : 0;
+		}
+	}
+};
+
+class thresholdRow {
+public:
+	thresholdRow(const uchar *row, const uchar *lut) : _row(row), _lut(lut) {}
+
+	uchar operator[](const int c) const {
+		return _lut[_row[c]];
+	}
+
+private:
+	const uchar *_row;
+	const uchar *_lut;
+};
+
+inline thresholdRow imageRow(const thresholdImage& img, int r){
+	return thresholdRow(imageRow(img.img, r), img.lut);
+}
+
+// Trackers are notified by the first scans of the engines about provisional labels, so that features of 
+// the components can be collected while labeling. labelTracker ignores everything, at no cost, and 
+// trackers derive from it to override only the notifications they need.
+struct labelTracker{
+	// New provisional label 'label', assigned to the block (or pixel) in row r and column c
+	void newLabel(uint, int, int) {}
+
+	// The block (or pixel) in row r and column c has got its provisional label, which is labels_row[c] 
+	// (0 if background). The row is read only by trackers which need it, so that memory tests are not affected.
+	template <typename RowT>
+	void labeled(const RowT&, int, int) {}
+};
+
+// Labels of 2x2 blocks, for engines which store provisional labels only in the top left pixel of every 
+// block (BBDT): one label for every block, in a matrix a quarter of the size of the image. Rows are 
+// accessed with the coordinates of the pixels, which must be even.
+struct blockLabels{
+	cv::Mat1i blocks;
+
+	blockLabels(cv::Size size) : blocks((size.height + 1) / 2, (size.width + 1) / 2) {}
+};
+
+class blockRow {
+public:
+	blockRow(uint *row) : _row(row) {}
+
+	uint& operator[](const int c) const {
+		return _row[c >> 1];
+	}
+
+private:
+	uint *_row;
+};
+
+inline blockRow labelsRow(blockLabels& labels, int r){
+	return blockRow((uint *)(labels.blocks.data + (ptrdiff_t)(r >> 1) * (ptrdiff_t)labels.blocks.step.p[0]));
+}
+
+// Labels of the last rows only, for engines which label pairs of rows looking at the row above them (CTB) 
+// when the label image is not needed after the first scan: four rows, reused every two pairs. Background 
+// pixels must read 0, so the rows of a pair are cleared when its first row (even) is requested: engines 
+// must request it before the other rows of the pair, as firstScanCTB_OPT does.
+struct rollingLabels{
+	cv::Mat1i rows;
+
+	rollingLabels(cv::Size size) : rows(4, size.width) {}
+};
+
+inline uint* labelsRow(rollingLabels& labels, int r){
+	uint * const row = (uint *)(labels.rows.data + (ptrdiff_t)(r & 3) * (ptrdiff_t)labels.rows.step.p[0]);
+	if ((r & 1) == 0)
+		memset(row, 0, 2 * labels.rows.step.p[0]);
+	return row;
+}
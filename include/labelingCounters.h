@@ -0,0 +1,80 @@
+// Copyright(c) 2016 - Costantino Grana, Federico Bolelli, Lorenzo Baraldi and Roberto Vezzani
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// *Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+// 
+// * Neither the name of YACCLAB nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include <cstring>
+
+// Events counted inside the labeling engines. Counters are compiled in only when
+// CCL_COUNTERS is defined, otherwise every COUNT_* macro expands to nothing and
+// the engines are exactly the ones measured by the timing tests.
+enum countertype{
+
+	// Equivalence resolution work
+	CT_PROVISIONAL_LABELS = 0,	// Provisional labels created (lunique - 1)
+	CT_UNIONS = 1,				// Calls to set_union
+	CT_FINDROOT_STEPS = 2,		// Total path length walked by findRoot and by the root searches of the solvers
+	CT_RELINK_STEPS = 3,		// Nodes relinked by reslove2/reslove3 (CCIT_OPT) and by ufLists
+
+	// Total number of counters in the list
+	CT_SIZE = 4,
+};
+
+// BBDT actions are numbered from 1 to 16 (action 13 does not exist)
+#define BBDT_ACTIONS_SIZE 17
+
+struct labelingCounters{
+
+	unsigned long long events[CT_SIZE];
+	unsigned long long bbdtActions[BBDT_ACTIONS_SIZE];	// Leaf hits of BBDT decision tree, grouped by action
+
+	labelingCounters(){
+		reset(); 
+	}
+
+	void reset(){
+		memset(events, 0, sizeof(events));
+		memset(bbdtActions, 0, sizeof(bbdtActions));
+	}
+};
+
+// Counters of the current thread: the driver resets them before running an algorithm 
+// and reads them back when it returns
+inline labelingCounters& cclCounters(){
+	static thread_local labelingCounters counters;
+	return counters; 
+}
+
+#ifdef CCL_COUNTERS
+#define COUNT_EVENT(type) (cclCounters().events[type]++)
+#define COUNT_EVENTS(type, n) (cclCounters().events[type] += (n))
+#define COUNT_BBDT_ACTION(n) (cclCounters().bbdtActions[n]++)
+#else
+#define COUNT_EVENT(type) ((void)0)
+#define COUNT_EVENTS(type, n) ((void)0)
+#define COUNT_BBDT_ACTION(n) ((void)0)
+#endif
@@ -27,6 +27,9 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "labelingGrana2010.h"
+#include "labelingAccess.h"
+#include "contourTracing.h"
+#include "componentFeatures.h"
 
 using namespace cv;
 using namespace std;
@@ -771,50 +774,65 @@ void firstScanBBDT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &lunique) {
 			// pixel of the block in the labels image
 
 		action_1:	//Action_1: No action (the block has no foreground pixels)
+			COUNT_BBDT_ACTION(1);
 			imgLabels(r, c) = 0;
 			continue;
 		action_2:	//Action_2: New label (the block has foreground pixels and is not connected to anything else)
+			COUNT_BBDT_ACTION(2);
 			imgLabels(r, c) = lunique;
 			P[lunique] = lunique;
 			lunique = lunique + 1;
 			continue;
 		action_3:	//Action_3: Assign label of block P
+			COUNT_BBDT_ACTION(3);
 			imgLabels(r, c) = imgLabels(r - 2, c - 2);
 			continue;
 		action_4:	//Action_4: Assign label of block Q 
+			COUNT_BBDT_ACTION(4);
 			imgLabels(r, c) = imgLabels(r - 2, c);
 			continue;
 		action_5:	//Action_5: Assign label of block R
+			COUNT_BBDT_ACTION(5);
 			imgLabels(r, c) = imgLabels(r - 2, c + 2);
 			continue;
 		action_6:	//Action_6: Assign label of block S
+			COUNT_BBDT_ACTION(6);
 			imgLabels(r, c) = imgLabels(r, c - 2);
 			continue;
 		action_7:	//Action_7: Merge labels of block P and Q
+			COUNT_BBDT_ACTION(7);
 			imgLabels(r, c) = set_union(P, (uint)imgLabels(r - 2, c - 2), (uint)imgLabels(r - 2, c));
 			continue;
 		action_8:	//Action_8: Merge labels of block P and R
+			COUNT_BBDT_ACTION(8);
 			imgLabels(r, c) = set_union(P, (uint)imgLabels(r - 2, c - 2), (uint)imgLabels(r - 2, c + 2));
 			continue;
 		action_9:	// Action_9 Merge labels of block P and S
+			COUNT_BBDT_ACTION(9);
 			imgLabels(r, c) = set_union(P, (uint)imgLabels(r - 2, c - 2), (uint)imgLabels(r, c - 2));
 			continue;
 		action_10:	// Action_10 Merge labels of block Q and R
+			COUNT_BBDT_ACTION(10);
 			imgLabels(r, c) = set_union(P, (uint)imgLabels(r - 2, c), (uint)imgLabels(r - 2, c + 2));
 			continue;
 		action_11:	//Action_11: Merge labels of block Q and S
+			COUNT_BBDT_ACTION(11);
 			imgLabels(r, c) = set_union(P, (uint)imgLabels(r - 2, c), (uint)imgLabels(r, c - 2));
 			continue;
 		action_12:	//Action_12: Merge labels of block R and S
+			COUNT_BBDT_ACTION(12);
 			imgLabels(r, c) = set_union(P, (uint)imgLabels(r - 2, c + 2), (uint)imgLabels(r, c - 2));
 			continue;
 		action_14:	//Action_14: Merge labels of block P, Q and S
+			COUNT_BBDT_ACTION(14);
 			imgLabels(r, c) = set_union(P, set_union(P, (uint)imgLabels(r - 2, c - 2), (uint)imgLabels(r - 2, c)), (uint)imgLabels(r, c - 2));
 			continue;
 		action_15:	//Action_15: Merge labels of block P, R and S
+			COUNT_BBDT_ACTION(15);
 			imgLabels(r, c) = set_union(P, set_union(P, (uint)imgLabels(r - 2, c - 2), (uint)imgLabels(r - 2, c + 2)), (uint)imgLabels(r, c - 2));
 			continue;
 		action_16:	//Action_16: labels of block Q, R and S
+			COUNT_BBDT_ACTION(16);
 			imgLabels(r, c) = set_union(P, set_union(P, (uint)imgLabels(r - 2, c), (uint)imgLabels(r - 2, c + 2)), (uint)imgLabels(r, c - 2));
 			continue;
 		}
@@ -847,7 +865,7 @@ int BBDT(const Mat1b &img, Mat1i &imgLabels) {
 	imgLabels = cv::Mat1i(img.size());
 
 	//A quick and dirty upper bound for the maximimum number of labels.
-	const size_t Plength = img.rows*img.cols / 4;
+	const size_t Plength = ((size_t)img.rows + 1) / 2 * (((size_t)img.cols + 1) / 2) + 1;
 
 	//Tree of labels
 	vector<uint> P(Plength);
@@ -857,6 +875,7 @@ int BBDT(const Mat1b &img, Mat1i &imgLabels) {
 	uint lunique = 1;
 
 	firstScanBBDT(img, imgLabels, P.data(), lunique);
+	COUNT_EVENTS(CT_PROVISIONAL_LABELS, lunique - 1);
 
 	uint nLabel = flattenL(P.data(), lunique);
 
@@ -912,19 +931,22 @@ int BBDT(const Mat1b &img, Mat1i &imgLabels) {
 	return nLabel;
 }
 
+// 'tracker' is notified of every new provisional label and of every labeled block (see labelTracker in labelingAccess.h)
+template <typename ImgT, typename LabelsT, typename EquivT, typename TrackerT>
 inline static
-void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &lunique) {
+void firstScanBBDT_OPT(ImgT &img, LabelsT& imgLabels, EquivT &P, uint &lunique, TrackerT &tracker) {
 	int w(img.cols), h(img.rows);
 
 	for (int r = 0; r<h; r += 2) {
 		// Get rows pointer
-		const uchar* const img_row = img.ptr<uchar>(r);
-		const uchar* const img_row_prev = (uchar *)(((char *)img_row) - img.step.p[0]);
-		const uchar* const img_row_prev_prev = (uchar *)(((char *)img_row_prev) - img.step.p[0]);
-		const uchar* const img_row_fol = (uchar *)(((char *)img_row) + img.step.p[0]);
-		uint* const imgLabels_row = imgLabels.ptr<uint>(r);
-		uint* const imgLabels_row_prev_prev = (uint *)(((char *)imgLabels_row) - imgLabels.step.p[0] - imgLabels.step.p[0]);
-		for (int c = 0; c < w; c += 2) {
+		const auto img_row = imageRow(img, r);
+		const auto img_row_prev = imageRow(img, r - 1);
+		const auto img_row_prev_prev = imageRow(img, r - 2);
+		const auto img_row_fol = imageRow(img, r + 1);
+		const auto imgLabels_row = labelsRow(imgLabels, r);
+		const auto imgLabels_row_prev_prev = labelsRow(imgLabels, r - 2);
+		// Actions end with continue, so the tracker is notified in the increment
+		for (int c = 0; c < w; tracker.labeled(imgLabels_row, r, c), c += 2) {
 
 			// We work with 2x2 blocks
 			// +-+-+-+
@@ -978,6 +1000,7 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 					if (condition_j) {
 						if (condition_i) {
 							//Action_6: Assign label of block S
+							COUNT_BBDT_ACTION(6);
 							imgLabels_row[c] = imgLabels_row[c - 2];
 							continue;
 						}
@@ -985,6 +1008,7 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 							if (condition_c) {
 								if (condition_h) {
 									//Action_6: Assign label of block S
+									COUNT_BBDT_ACTION(6);
 									imgLabels_row[c] = imgLabels_row[c - 2];
 									continue;
 								}
@@ -992,17 +1016,20 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 									if (condition_g) {
 										if (condition_b) {
 											//Action_6: Assign label of block S
+											COUNT_BBDT_ACTION(6);
 											imgLabels_row[c] = imgLabels_row[c - 2];
 											continue;
 										}
 										else {
 											//Action_11: Merge labels of block Q and S
+											COUNT_BBDT_ACTION(11);
 											imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c], imgLabels_row[c - 2]);
 											continue;
 										}
 									}
 									else {
 										//Action_11: Merge labels of block Q and S
+										COUNT_BBDT_ACTION(11);
 										imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c], imgLabels_row[c - 2]);
 										continue;
 									}
@@ -1010,6 +1037,7 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 							}
 							else {
 								//Action_11: Merge labels of block Q and S
+								COUNT_BBDT_ACTION(11);
 								imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c], imgLabels_row[c - 2]);
 								continue;
 							}
@@ -1021,6 +1049,7 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 								if (condition_d) {
 									if (condition_i) {
 										//Action_6: Assign label of block S
+										COUNT_BBDT_ACTION(6);
 										imgLabels_row[c] = imgLabels_row[c - 2];
 										continue;
 									}
@@ -1028,6 +1057,7 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 										if (condition_c) {
 											if (condition_h) {
 												//Action_6: Assign label of block S
+												COUNT_BBDT_ACTION(6);
 												imgLabels_row[c] = imgLabels_row[c - 2];
 												continue;
 											}
@@ -1035,17 +1065,20 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 												if (condition_g) {
 													if (condition_b) {
 														//Action_6: Assign label of block S
+														COUNT_BBDT_ACTION(6);
 														imgLabels_row[c] = imgLabels_row[c - 2];
 														continue;
 													}
 													else {
 														//Action_12: Merge labels of block R and S
+														COUNT_BBDT_ACTION(12);
 														imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c + 2], imgLabels_row[c - 2]);
 														continue;
 													}
 												}
 												else {
 													//Action_12: Merge labels of block R and S
+													COUNT_BBDT_ACTION(12);
 													imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c + 2], imgLabels_row[c - 2]);
 													continue;
 												}
@@ -1053,6 +1086,7 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 										}
 										else {
 											//Action_12: Merge labels of block R and S
+											COUNT_BBDT_ACTION(12);
 											imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c + 2], imgLabels_row[c - 2]);
 											continue;
 										}
@@ -1060,18 +1094,21 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 								}
 								else {
 									//Action_12: Merge labels of block R and S
+									COUNT_BBDT_ACTION(12);
 									imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c + 2], imgLabels_row[c - 2]);
 									continue;
 								}
 							}
 							else {
 								//Action_6: Assign label of block S
+								COUNT_BBDT_ACTION(6);
 								imgLabels_row[c] = imgLabels_row[c - 2];
 								continue;
 							}
 						}
 						else {
 							//Action_6: Assign label of block S
+							COUNT_BBDT_ACTION(6);
 							imgLabels_row[c] = imgLabels_row[c - 2];
 							continue;
 						}
@@ -1084,17 +1121,20 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 								if (condition_h) {
 									if (condition_i) {
 										//Action_6: Assign label of block S
+										COUNT_BBDT_ACTION(6);
 										imgLabels_row[c] = imgLabels_row[c - 2];
 										continue;
 									}
 									else {
 										if (condition_c) {
 											//Action_6: Assign label of block S
+											COUNT_BBDT_ACTION(6);
 											imgLabels_row[c] = imgLabels_row[c - 2];
 											continue;
 										}
 										else {
 											//Action_11: Merge labels of block Q and S
+											COUNT_BBDT_ACTION(11);
 											imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c], imgLabels_row[c - 2]);
 											continue;
 										}
@@ -1105,17 +1145,20 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 										if (condition_b) {
 											if (condition_i) {
 												//Action_6: Assign label of block S
+												COUNT_BBDT_ACTION(6);
 												imgLabels_row[c] = imgLabels_row[c - 2];
 												continue;
 											}
 											else {
 												if (condition_c) {
 													//Action_6: Assign label of block S
+													COUNT_BBDT_ACTION(6);
 													imgLabels_row[c] = imgLabels_row[c - 2];
 													continue;
 												}
 												else {
 													//Action_11: Merge labels of block Q and S
+													COUNT_BBDT_ACTION(11);
 													imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c], imgLabels_row[c - 2]);
 													continue;
 												}
@@ -1123,12 +1166,14 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 										}
 										else {
 											//Action_11: Merge labels of block Q and S
+											COUNT_BBDT_ACTION(11);
 											imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c], imgLabels_row[c - 2]);
 											continue;
 										}
 									}
 									else {
 										//Action_11: Merge labels of block Q and S
+										COUNT_BBDT_ACTION(11);
 										imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c], imgLabels_row[c - 2]);
 										continue;
 									}
@@ -1137,6 +1182,7 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 							else {
 								if (condition_i) {
 									//Action_11: Merge labels of block Q and S
+									COUNT_BBDT_ACTION(11);
 									imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c], imgLabels_row[c - 2]);
 									continue;
 								}
@@ -1144,17 +1190,20 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 									if (condition_h) {
 										if (condition_c) {
 											//Action_11: Merge labels of block Q and S
+											COUNT_BBDT_ACTION(11);
 											imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c], imgLabels_row[c - 2]);
 											continue;
 										}
 										else {
 											//Action_14: Merge labels of block P, Q and S
+											COUNT_BBDT_ACTION(14);
 											imgLabels_row[c] = set_union(P, set_union(P, imgLabels_row_prev_prev[c - 2], imgLabels_row_prev_prev[c]), imgLabels_row[c - 2]);
 											continue;
 										}
 									}
 									else {
 										//Action_11: Merge labels of block Q and S
+										COUNT_BBDT_ACTION(11);
 										imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c], imgLabels_row[c - 2]);
 										continue;
 									}
@@ -1169,17 +1218,20 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 											if (condition_d) {
 												if (condition_i) {
 													//Action_6: Assign label of block S
+													COUNT_BBDT_ACTION(6);
 													imgLabels_row[c] = imgLabels_row[c - 2];
 													continue;
 												}
 												else {
 													if (condition_c) {
 														//Action_6: Assign label of block S
+														COUNT_BBDT_ACTION(6);
 														imgLabels_row[c] = imgLabels_row[c - 2];
 														continue;
 													}
 													else {
 														//Action_12: Merge labels of block R and S
+														COUNT_BBDT_ACTION(12);
 														imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c + 2], imgLabels_row[c - 2]);
 														continue;
 													}
@@ -1187,6 +1239,7 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 											}
 											else {
 												//Action_12: Merge labels of block R and S
+												COUNT_BBDT_ACTION(12);
 												imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c + 2], imgLabels_row[c - 2]);
 												continue;
 											}
@@ -1197,17 +1250,20 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 													if (condition_b) {
 														if (condition_i) {
 															//Action_6: Assign label of block S
+															COUNT_BBDT_ACTION(6);
 															imgLabels_row[c] = imgLabels_row[c - 2];
 															continue;
 														}
 														else {
 															if (condition_c) {
 																//Action_6: Assign label of block S
+																COUNT_BBDT_ACTION(6);
 																imgLabels_row[c] = imgLabels_row[c - 2];
 																continue;
 															}
 															else {
 																//Action_12: Merge labels of block R and S
+																COUNT_BBDT_ACTION(12);
 																imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c + 2], imgLabels_row[c - 2]);
 																continue;
 															}
@@ -1215,12 +1271,14 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 													}
 													else {
 														//Action_12: Merge labels of block R and S
+														COUNT_BBDT_ACTION(12);
 														imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c + 2], imgLabels_row[c - 2]);
 														continue;
 													}
 												}
 												else {
 													//Action_12: Merge labels of block R and S
+													COUNT_BBDT_ACTION(12);
 													imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c + 2], imgLabels_row[c - 2]);
 													continue;
 												}
@@ -1230,23 +1288,27 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 													if (condition_g) {
 														if (condition_b) {
 															//Action_12: Merge labels of block R and S
+															COUNT_BBDT_ACTION(12);
 															imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c + 2], imgLabels_row[c - 2]);
 															continue;
 														}
 														else {
 															//Action_16: labels of block Q, R and S
+															COUNT_BBDT_ACTION(16);
 															imgLabels_row[c] = set_union(P, set_union(P, imgLabels_row_prev_prev[c], imgLabels_row_prev_prev[c + 2]), imgLabels_row[c - 2]);
 															continue;
 														}
 													}
 													else {
 														//Action_16: labels of block Q, R and S
+														COUNT_BBDT_ACTION(16);
 														imgLabels_row[c] = set_union(P, set_union(P, imgLabels_row_prev_prev[c], imgLabels_row_prev_prev[c + 2]), imgLabels_row[c - 2]);
 														continue;
 													}
 												}
 												else {
 													//Action_12: Merge labels of block R and S
+													COUNT_BBDT_ACTION(12);
 													imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c + 2], imgLabels_row[c - 2]);
 													continue;
 												}
@@ -1257,11 +1319,13 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 										if (condition_i) {
 											if (condition_d) {
 												//Action_12: Merge labels of block R and S
+												COUNT_BBDT_ACTION(12);
 												imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c + 2], imgLabels_row[c - 2]);
 												continue;
 											}
 											else {
 												//Action_16: labels of block Q, R and S
+												COUNT_BBDT_ACTION(16);
 												imgLabels_row[c] = set_union(P, set_union(P, imgLabels_row_prev_prev[c], imgLabels_row_prev_prev[c + 2]), imgLabels_row[c - 2]);
 												continue;
 											}
@@ -1271,23 +1335,27 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 												if (condition_d) {
 													if (condition_c) {
 														//Action_12: Merge labels of block R and S
+														COUNT_BBDT_ACTION(12);
 														imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c + 2], imgLabels_row[c - 2]);
 														continue;
 													}
 													else {
 														//Action_15: Merge labels of block P, R and S
+														COUNT_BBDT_ACTION(15);
 														imgLabels_row[c] = set_union(P, set_union(P, imgLabels_row_prev_prev[c - 2], imgLabels_row_prev_prev[c + 2]), imgLabels_row[c - 2]);
 														continue;
 													}
 												}
 												else {
 													//Action_15: Merge labels of block P, R and S
+													COUNT_BBDT_ACTION(15);
 													imgLabels_row[c] = set_union(P, set_union(P, imgLabels_row_prev_prev[c - 2], imgLabels_row_prev_prev[c + 2]), imgLabels_row[c - 2]);
 													continue;
 												}
 											}
 											else {
 												//Action_12: Merge labels of block R and S
+												COUNT_BBDT_ACTION(12);
 												imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c + 2], imgLabels_row[c - 2]);
 												continue;
 											}
@@ -1298,11 +1366,13 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 									if (condition_h) {
 										if (condition_m) {
 											//Action_6: Assign label of block S
+											COUNT_BBDT_ACTION(6);
 											imgLabels_row[c] = imgLabels_row[c - 2];
 											continue;
 										}
 										else {
 											// ACTION_9 Merge labels of block P and S
+											COUNT_BBDT_ACTION(9);
 											imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c - 2], imgLabels_row[c - 2]);
 											continue;
 										}
@@ -1313,29 +1383,34 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 												if (condition_g) {
 													if (condition_b) {
 														//Action_6: Assign label of block S
+														COUNT_BBDT_ACTION(6);
 														imgLabels_row[c] = imgLabels_row[c - 2];
 														continue;
 													}
 													else {
 														//Action_11: Merge labels of block Q and S
+														COUNT_BBDT_ACTION(11);
 														imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c], imgLabels_row[c - 2]);
 														continue;
 													}
 												}
 												else {
 													//Action_11: Merge labels of block Q and S
+													COUNT_BBDT_ACTION(11);
 													imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c], imgLabels_row[c - 2]);
 													continue;
 												}
 											}
 											else {
 												//Action_11: Merge labels of block Q and S
+												COUNT_BBDT_ACTION(11);
 												imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c], imgLabels_row[c - 2]);
 												continue;
 											}
 										}
 										else {
 											//Action_6: Assign label of block S
+											COUNT_BBDT_ACTION(6);
 											imgLabels_row[c] = imgLabels_row[c - 2];
 											continue;
 										}
@@ -1346,11 +1421,13 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 								if (condition_h) {
 									if (condition_m) {
 										//Action_6: Assign label of block S
+										COUNT_BBDT_ACTION(6);
 										imgLabels_row[c] = imgLabels_row[c - 2];
 										continue;
 									}
 									else {
 										// ACTION_9 Merge labels of block P and S
+										COUNT_BBDT_ACTION(9);
 										imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c - 2], imgLabels_row[c - 2]);
 										continue;
 									}
@@ -1361,29 +1438,34 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 											if (condition_g) {
 												if (condition_b) {
 													//Action_6: Assign label of block S
+													COUNT_BBDT_ACTION(6);
 													imgLabels_row[c] = imgLabels_row[c - 2];
 													continue;
 												}
 												else {
 													//Action_11: Merge labels of block Q and S
+													COUNT_BBDT_ACTION(11);
 													imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c], imgLabels_row[c - 2]);
 													continue;
 												}
 											}
 											else {
 												//Action_11: Merge labels of block Q and S
+												COUNT_BBDT_ACTION(11);
 												imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c], imgLabels_row[c - 2]);
 												continue;
 											}
 										}
 										else {
 											//Action_11: Merge labels of block Q and S
+											COUNT_BBDT_ACTION(11);
 											imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c], imgLabels_row[c - 2]);
 											continue;
 										}
 									}
 									else {
 										//Action_6: Assign label of block S
+										COUNT_BBDT_ACTION(6);
 										imgLabels_row[c] = imgLabels_row[c - 2];
 										continue;
 									}
@@ -1395,6 +1477,7 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 						if (condition_j) {
 							if (condition_i) {
 								//Action_4: Assign label of block Q 
+								COUNT_BBDT_ACTION(4);
 								imgLabels_row[c] = imgLabels_row_prev_prev[c];
 								continue;
 							}
@@ -1402,17 +1485,20 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 								if (condition_h) {
 									if (condition_c) {
 										//Action_4: Assign label of block Q 
+										COUNT_BBDT_ACTION(4);
 										imgLabels_row[c] = imgLabels_row_prev_prev[c];
 										continue;
 									}
 									else {
 										//Action_7: Merge labels of block P and Q
+										COUNT_BBDT_ACTION(7);
 										imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c - 2], imgLabels_row_prev_prev[c]);
 										continue;
 									}
 								}
 								else {
 									//Action_4: Assign label of block Q 
+									COUNT_BBDT_ACTION(4);
 									imgLabels_row[c] = imgLabels_row_prev_prev[c];
 									continue;
 								}
@@ -1424,11 +1510,13 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 									if (condition_i) {
 										if (condition_d) {
 											//Action_5: Assign label of block R
+											COUNT_BBDT_ACTION(5);
 											imgLabels_row[c] = imgLabels_row_prev_prev[c + 2];
 											continue;
 										}
 										else {
 											// ACTION_10 Merge labels of block Q and R
+											COUNT_BBDT_ACTION(10);
 											imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c], imgLabels_row_prev_prev[c + 2]);
 											continue;
 										}
@@ -1438,23 +1526,27 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 											if (condition_d) {
 												if (condition_c) {
 													//Action_5: Assign label of block R
+													COUNT_BBDT_ACTION(5);
 													imgLabels_row[c] = imgLabels_row_prev_prev[c + 2];
 													continue;
 												}
 												else {
 													//Action_8: Merge labels of block P and R
+													COUNT_BBDT_ACTION(8);
 													imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c - 2], imgLabels_row_prev_prev[c + 2]);
 													continue;
 												}
 											}
 											else {
 												//Action_8: Merge labels of block P and R
+												COUNT_BBDT_ACTION(8);
 												imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c - 2], imgLabels_row_prev_prev[c + 2]);
 												continue;
 											}
 										}
 										else {
 											//Action_5: Assign label of block R
+											COUNT_BBDT_ACTION(5);
 											imgLabels_row[c] = imgLabels_row_prev_prev[c + 2];
 											continue;
 										}
@@ -1463,19 +1555,23 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 								else {
 									if (condition_i) {
 										//Action_4: Assign label of block Q 
+										COUNT_BBDT_ACTION(4);
 										imgLabels_row[c] = imgLabels_row_prev_prev[c];
 										continue;
 									}
 									else {
 										if (condition_h) {
 											//Action_3: Assign label of block P
+											COUNT_BBDT_ACTION(3);
 											imgLabels_row[c] = imgLabels_row_prev_prev[c - 2];
 											continue;
 										}
 										else {
 											//Action_2: New label (the block has foreground pixels and is not connected to anything else)
+											COUNT_BBDT_ACTION(2);
 											imgLabels_row[c] = lunique;
 											P[lunique] = lunique;
+											tracker.newLabel(lunique, r, c);
 											lunique = lunique + 1;
 											continue;
 										}
@@ -1485,19 +1581,23 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 							else {
 								if (condition_i) {
 									//Action_4: Assign label of block Q 
+									COUNT_BBDT_ACTION(4);
 									imgLabels_row[c] = imgLabels_row_prev_prev[c];
 									continue;
 								}
 								else {
 									if (condition_h) {
 										//Action_3: Assign label of block P
+										COUNT_BBDT_ACTION(3);
 										imgLabels_row[c] = imgLabels_row_prev_prev[c - 2];
 										continue;
 									}
 									else {
 										//Action_2: New label (the block has foreground pixels and is not connected to anything else)
+										COUNT_BBDT_ACTION(2);
 										imgLabels_row[c] = lunique;
 										P[lunique] = lunique;
+										tracker.newLabel(lunique, r, c);
 										lunique = lunique + 1;
 										continue;
 									}
@@ -1514,6 +1614,7 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 							if (condition_j) {
 								if (condition_i) {
 									//Action_6: Assign label of block S
+									COUNT_BBDT_ACTION(6);
 									imgLabels_row[c] = imgLabels_row[c - 2];
 									continue;
 								}
@@ -1521,6 +1622,7 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 									if (condition_c) {
 										if (condition_h) {
 											//Action_6: Assign label of block S
+											COUNT_BBDT_ACTION(6);
 											imgLabels_row[c] = imgLabels_row[c - 2];
 											continue;
 										}
@@ -1528,17 +1630,20 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 											if (condition_g) {
 												if (condition_b) {
 													//Action_6: Assign label of block S
+													COUNT_BBDT_ACTION(6);
 													imgLabels_row[c] = imgLabels_row[c - 2];
 													continue;
 												}
 												else {
 													//Action_11: Merge labels of block Q and S
+													COUNT_BBDT_ACTION(11);
 													imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c], imgLabels_row[c - 2]);
 													continue;
 												}
 											}
 											else {
 												//Action_11: Merge labels of block Q and S
+												COUNT_BBDT_ACTION(11);
 												imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c], imgLabels_row[c - 2]);
 												continue;
 											}
@@ -1546,6 +1651,7 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 									}
 									else {
 										//Action_11: Merge labels of block Q and S
+										COUNT_BBDT_ACTION(11);
 										imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c], imgLabels_row[c - 2]);
 										continue;
 									}
@@ -1556,6 +1662,7 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 									if (condition_d) {
 										if (condition_i) {
 											//Action_6: Assign label of block S
+											COUNT_BBDT_ACTION(6);
 											imgLabels_row[c] = imgLabels_row[c - 2];
 											continue;
 										}
@@ -1563,6 +1670,7 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 											if (condition_c) {
 												if (condition_h) {
 													//Action_6: Assign label of block S
+													COUNT_BBDT_ACTION(6);
 													imgLabels_row[c] = imgLabels_row[c - 2];
 													continue;
 												}
@@ -1570,17 +1678,20 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 													if (condition_g) {
 														if (condition_b) {
 															//Action_6: Assign label of block S
+															COUNT_BBDT_ACTION(6);
 															imgLabels_row[c] = imgLabels_row[c - 2];
 															continue;
 														}
 														else {
 															//Action_12: Merge labels of block R and S
+															COUNT_BBDT_ACTION(12);
 															imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c + 2], imgLabels_row[c - 2]);
 															continue;
 														}
 													}
 													else {
 														//Action_12: Merge labels of block R and S
+														COUNT_BBDT_ACTION(12);
 														imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c + 2], imgLabels_row[c - 2]);
 														continue;
 													}
@@ -1588,6 +1699,7 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 											}
 											else {
 												//Action_12: Merge labels of block R and S
+												COUNT_BBDT_ACTION(12);
 												imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c + 2], imgLabels_row[c - 2]);
 												continue;
 											}
@@ -1595,12 +1707,14 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 									}
 									else {
 										//Action_12: Merge labels of block R and S
+										COUNT_BBDT_ACTION(12);
 										imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c + 2], imgLabels_row[c - 2]);
 										continue;
 									}
 								}
 								else {
 									//Action_6: Assign label of block S
+									COUNT_BBDT_ACTION(6);
 									imgLabels_row[c] = imgLabels_row[c - 2];
 									continue;
 								}
@@ -1613,17 +1727,20 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 										if (condition_h) {
 											if (condition_i) {
 												//Action_6: Assign label of block S
+												COUNT_BBDT_ACTION(6);
 												imgLabels_row[c] = imgLabels_row[c - 2];
 												continue;
 											}
 											else {
 												if (condition_c) {
 													//Action_6: Assign label of block S
+													COUNT_BBDT_ACTION(6);
 													imgLabels_row[c] = imgLabels_row[c - 2];
 													continue;
 												}
 												else {
 													//Action_11: Merge labels of block Q and S
+													COUNT_BBDT_ACTION(11);
 													imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c], imgLabels_row[c - 2]);
 													continue;
 												}
@@ -1634,17 +1751,20 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 												if (condition_b) {
 													if (condition_i) {
 														//Action_6: Assign label of block S
+														COUNT_BBDT_ACTION(6);
 														imgLabels_row[c] = imgLabels_row[c - 2];
 														continue;
 													}
 													else {
 														if (condition_c) {
 															//Action_6: Assign label of block S
+															COUNT_BBDT_ACTION(6);
 															imgLabels_row[c] = imgLabels_row[c - 2];
 															continue;
 														}
 														else {
 															//Action_11: Merge labels of block Q and S
+															COUNT_BBDT_ACTION(11);
 															imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c], imgLabels_row[c - 2]);
 															continue;
 														}
@@ -1652,12 +1772,14 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 												}
 												else {
 													//Action_11: Merge labels of block Q and S
+													COUNT_BBDT_ACTION(11);
 													imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c], imgLabels_row[c - 2]);
 													continue;
 												}
 											}
 											else {
 												//Action_11: Merge labels of block Q and S
+												COUNT_BBDT_ACTION(11);
 												imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c], imgLabels_row[c - 2]);
 												continue;
 											}
@@ -1665,6 +1787,7 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 									}
 									else {
 										//Action_11: Merge labels of block Q and S
+										COUNT_BBDT_ACTION(11);
 										imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c], imgLabels_row[c - 2]);
 										continue;
 									}
@@ -1676,17 +1799,20 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 												if (condition_h) {
 													if (condition_i) {
 														//Action_6: Assign label of block S
+														COUNT_BBDT_ACTION(6);
 														imgLabels_row[c] = imgLabels_row[c - 2];
 														continue;
 													}
 													else {
 														if (condition_c) {
 															//Action_6: Assign label of block S
+															COUNT_BBDT_ACTION(6);
 															imgLabels_row[c] = imgLabels_row[c - 2];
 															continue;
 														}
 														else {
 															//Action_12: Merge labels of block R and S
+															COUNT_BBDT_ACTION(12);
 															imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c + 2], imgLabels_row[c - 2]);
 															continue;
 														}
@@ -1697,17 +1823,20 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 														if (condition_b) {
 															if (condition_i) {
 																//Action_6: Assign label of block S
+																COUNT_BBDT_ACTION(6);
 																imgLabels_row[c] = imgLabels_row[c - 2];
 																continue;
 															}
 															else {
 																if (condition_c) {
 																	//Action_6: Assign label of block S
+																	COUNT_BBDT_ACTION(6);
 																	imgLabels_row[c] = imgLabels_row[c - 2];
 																	continue;
 																}
 																else {
 																	//Action_12: Merge labels of block R and S
+																	COUNT_BBDT_ACTION(12);
 																	imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c + 2], imgLabels_row[c - 2]);
 																	continue;
 																}
@@ -1715,12 +1844,14 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 														}
 														else {
 															//Action_12: Merge labels of block R and S
+															COUNT_BBDT_ACTION(12);
 															imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c + 2], imgLabels_row[c - 2]);
 															continue;
 														}
 													}
 													else {
 														//Action_12: Merge labels of block R and S
+														COUNT_BBDT_ACTION(12);
 														imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c + 2], imgLabels_row[c - 2]);
 														continue;
 													}
@@ -1728,6 +1859,7 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 											}
 											else {
 												//Action_12: Merge labels of block R and S
+												COUNT_BBDT_ACTION(12);
 												imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c + 2], imgLabels_row[c - 2]);
 												continue;
 											}
@@ -1737,6 +1869,7 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 												if (condition_m) {
 													if (condition_h) {
 														//Action_12: Merge labels of block R and S
+														COUNT_BBDT_ACTION(12);
 														imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c + 2], imgLabels_row[c - 2]);
 														continue;
 													}
@@ -1744,17 +1877,20 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 														if (condition_g) {
 															if (condition_b) {
 																//Action_12: Merge labels of block R and S
+																COUNT_BBDT_ACTION(12);
 																imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c + 2], imgLabels_row[c - 2]);
 																continue;
 															}
 															else {
 																//Action_16: labels of block Q, R and S
+																COUNT_BBDT_ACTION(16);
 																imgLabels_row[c] = set_union(P, set_union(P, imgLabels_row_prev_prev[c], imgLabels_row_prev_prev[c + 2]), imgLabels_row[c - 2]);
 																continue;
 															}
 														}
 														else {
 															//Action_16: labels of block Q, R and S
+															COUNT_BBDT_ACTION(16);
 															imgLabels_row[c] = set_union(P, set_union(P, imgLabels_row_prev_prev[c], imgLabels_row_prev_prev[c + 2]), imgLabels_row[c - 2]);
 															continue;
 														}
@@ -1762,12 +1898,14 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 												}
 												else {
 													//Action_16: labels of block Q, R and S
+													COUNT_BBDT_ACTION(16);
 													imgLabels_row[c] = set_union(P, set_union(P, imgLabels_row_prev_prev[c], imgLabels_row_prev_prev[c + 2]), imgLabels_row[c - 2]);
 													continue;
 												}
 											}
 											else {
 												//Action_12: Merge labels of block R and S
+												COUNT_BBDT_ACTION(12);
 												imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c + 2], imgLabels_row[c - 2]);
 												continue;
 											}
@@ -1778,6 +1916,7 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 											if (condition_m) {
 												if (condition_h) {
 													//Action_6: Assign label of block S
+													COUNT_BBDT_ACTION(6);
 													imgLabels_row[c] = imgLabels_row[c - 2];
 													continue;
 												}
@@ -1785,17 +1924,20 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 													if (condition_g) {
 														if (condition_b) {
 															//Action_6: Assign label of block S
+															COUNT_BBDT_ACTION(6);
 															imgLabels_row[c] = imgLabels_row[c - 2];
 															continue;
 														}
 														else {
 															//Action_11: Merge labels of block Q and S
+															COUNT_BBDT_ACTION(11);
 															imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c], imgLabels_row[c - 2]);
 															continue;
 														}
 													}
 													else {
 														//Action_11: Merge labels of block Q and S
+														COUNT_BBDT_ACTION(11);
 														imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c], imgLabels_row[c - 2]);
 														continue;
 													}
@@ -1803,12 +1945,14 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 											}
 											else {
 												//Action_11: Merge labels of block Q and S
+												COUNT_BBDT_ACTION(11);
 												imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c], imgLabels_row[c - 2]);
 												continue;
 											}
 										}
 										else {
 											//Action_6: Assign label of block S
+											COUNT_BBDT_ACTION(6);
 											imgLabels_row[c] = imgLabels_row[c - 2];
 											continue;
 										}
@@ -1818,6 +1962,7 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 							else {
 								if (condition_j) {
 									//Action_4: Assign label of block Q 
+									COUNT_BBDT_ACTION(4);
 									imgLabels_row[c] = imgLabels_row_prev_prev[c];
 									continue;
 								}
@@ -1826,17 +1971,20 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 										if (condition_i) {
 											if (condition_d) {
 												//Action_5: Assign label of block R
+												COUNT_BBDT_ACTION(5);
 												imgLabels_row[c] = imgLabels_row_prev_prev[c + 2];
 												continue;
 											}
 											else {
 												// ACTION_10 Merge labels of block Q and R
+												COUNT_BBDT_ACTION(10);
 												imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c], imgLabels_row_prev_prev[c + 2]);
 												continue;
 											}
 										}
 										else {
 											//Action_5: Assign label of block R
+											COUNT_BBDT_ACTION(5);
 											imgLabels_row[c] = imgLabels_row_prev_prev[c + 2];
 											continue;
 										}
@@ -1844,13 +1992,16 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 									else {
 										if (condition_i) {
 											//Action_4: Assign label of block Q 
+											COUNT_BBDT_ACTION(4);
 											imgLabels_row[c] = imgLabels_row_prev_prev[c];
 											continue;
 										}
 										else {
 											//Action_2: New label (the block has foreground pixels and is not connected to anything else)
+											COUNT_BBDT_ACTION(2);
 											imgLabels_row[c] = lunique;
 											P[lunique] = lunique;
+											tracker.newLabel(lunique, r, c);
 											lunique = lunique + 1;
 											continue;
 										}
@@ -1862,19 +2013,23 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 					else {
 						if (condition_r) {
 							//Action_6: Assign label of block S
+							COUNT_BBDT_ACTION(6);
 							imgLabels_row[c] = imgLabels_row[c - 2];
 							continue;
 						}
 						else {
 							if (condition_n) {
 								//Action_6: Assign label of block S
+								COUNT_BBDT_ACTION(6);
 								imgLabels_row[c] = imgLabels_row[c - 2];
 								continue;
 							}
 							else {
 								//Action_2: New label (the block has foreground pixels and is not connected to anything else)
+								COUNT_BBDT_ACTION(2);
 								imgLabels_row[c] = lunique;
 								P[lunique] = lunique;
+								tracker.newLabel(lunique, r, c);
 								lunique = lunique + 1;
 								continue;
 							}
@@ -1885,6 +2040,7 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 					if (condition_p) {
 						if (condition_j) {
 							//Action_4: Assign label of block Q 
+							COUNT_BBDT_ACTION(4);
 							imgLabels_row[c] = imgLabels_row_prev_prev[c];
 							continue;
 						}
@@ -1893,17 +2049,20 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 								if (condition_i) {
 									if (condition_d) {
 										//Action_5: Assign label of block R
+										COUNT_BBDT_ACTION(5);
 										imgLabels_row[c] = imgLabels_row_prev_prev[c + 2];
 										continue;
 									}
 									else {
 										// ACTION_10 Merge labels of block Q and R
+										COUNT_BBDT_ACTION(10);
 										imgLabels_row[c] = set_union(P, imgLabels_row_prev_prev[c], imgLabels_row_prev_prev[c + 2]);
 										continue;
 									}
 								}
 								else {
 									//Action_5: Assign label of block R
+									COUNT_BBDT_ACTION(5);
 									imgLabels_row[c] = imgLabels_row_prev_prev[c + 2];
 									continue;
 								}
@@ -1911,13 +2070,16 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 							else {
 								if (condition_i) {
 									//Action_4: Assign label of block Q 
+									COUNT_BBDT_ACTION(4);
 									imgLabels_row[c] = imgLabels_row_prev_prev[c];
 									continue;
 								}
 								else {
 									//Action_2: New label (the block has foreground pixels and is not connected to anything else)
+									COUNT_BBDT_ACTION(2);
 									imgLabels_row[c] = lunique;
 									P[lunique] = lunique;
+									tracker.newLabel(lunique, r, c);
 									lunique = lunique + 1;
 									continue;
 								}
@@ -1927,13 +2089,16 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 					else {
 						if (condition_t) {
 							//Action_2: New label (the block has foreground pixels and is not connected to anything else)
+							COUNT_BBDT_ACTION(2);
 							imgLabels_row[c] = lunique;
 							P[lunique] = lunique;
+							tracker.newLabel(lunique, r, c);
 							lunique = lunique + 1;
 							continue;
 						}
 						else {
 							// Action_1: No action (the block has no foreground pixels)
+							COUNT_BBDT_ACTION(1);
 							imgLabels_row[c] = 0;
 							continue;
 						}
@@ -1965,32 +2130,20 @@ void firstScanBBDT_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &luniqu
 
 }
 
-int BBDT_OPT(const Mat1b &img, Mat1i &imgLabels) {
-	
-    imgLabels = cv::Mat1i(img.size());
-	//A quick and dirty upper bound for the maximimum number of labels.
-	const size_t Plength = img.rows*img.cols / 4;
-	//Tree of labels
-	uint *P = (uint *)fastMalloc(sizeof(uint)* Plength);
-	//Background
-	P[0] = 0;
-	uint lunique = 1;
-
-    firstScanBBDT_OPT(img, imgLabels, P, lunique);
-
-	uint nLabel = flattenL(P, lunique);
+template <typename ImgT, typename LabelsT, typename EquivT>
+inline static
+void secondScanBBDT_OPT(ImgT &img, LabelsT& imgLabels, EquivT &P) {
 
-	// Second scan
 	if (imgLabels.rows & 1){
 		if (imgLabels.cols & 1){
 			//Case 1: both rows and cols odd
 			for (int r = 0; r<imgLabels.rows; r += 2) {
 				// Get rows pointer
-				const uchar* const img_row = img.ptr<uchar>(r);
-				const uchar* const img_row_fol = (uchar *)(((char *)img_row) + img.step.p[0]);
+				const auto img_row = imageRow(img, r);
+				const auto img_row_fol = imageRow(img, r + 1);
 
-				uint* const imgLabels_row = imgLabels.ptr<uint>(r);
-				uint* const imgLabels_row_fol = (uint *)(((char *)imgLabels_row) + imgLabels.step.p[0]);
+				const auto imgLabels_row = labelsRow(imgLabels, r);
+				const auto imgLabels_row_fol = labelsRow(imgLabels, r + 1);
 				// Get rows pointer
 				for (int c = 0; c<imgLabels.cols; c += 2) {
 					int iLabel = imgLabels_row[c];
@@ -2043,11 +2196,11 @@ int BBDT_OPT(const Mat1b &img, Mat1i &imgLabels) {
 			//Case 2: only rows odd
 			for (int r = 0; r<imgLabels.rows; r += 2) {
 				// Get rows pointer
-				const uchar* const img_row = img.ptr<uchar>(r);
-				const uchar* const img_row_fol = (uchar *)(((char *)img_row) + img.step.p[0]);
+				const auto img_row = imageRow(img, r);
+				const auto img_row_fol = imageRow(img, r + 1);
 
-				uint* const imgLabels_row = imgLabels.ptr<uint>(r);
-				uint* const imgLabels_row_fol = (uint *)(((char *)imgLabels_row) + imgLabels.step.p[0]);
+				const auto imgLabels_row = labelsRow(imgLabels, r);
+				const auto imgLabels_row_fol = labelsRow(imgLabels, r + 1);
 				// Get rows pointer
 				for (int c = 0; c<imgLabels.cols; c += 2) {
 					int iLabel = imgLabels_row[c];
@@ -2089,11 +2242,11 @@ int BBDT_OPT(const Mat1b &img, Mat1i &imgLabels) {
 			//Case 3: only cols odd
 			for (int r = 0; r<imgLabels.rows; r += 2) {
 				// Get rows pointer
-				const uchar* const img_row = img.ptr<uchar>(r);
-				const uchar* const img_row_fol = (uchar *)(((char *)img_row) + img.step.p[0]);
+				const auto img_row = imageRow(img, r);
+				const auto img_row_fol = imageRow(img, r + 1);
 
-				uint* const imgLabels_row = imgLabels.ptr<uint>(r);
-				uint* const imgLabels_row_fol = (uint *)(((char *)imgLabels_row) + imgLabels.step.p[0]);
+				const auto imgLabels_row = labelsRow(imgLabels, r);
+				const auto imgLabels_row_fol = labelsRow(imgLabels, r + 1);
 				// Get rows pointer
 				for (int c = 0; c<imgLabels.cols; c += 2) {
 					int iLabel = imgLabels_row[c];
@@ -2133,11 +2286,11 @@ int BBDT_OPT(const Mat1b &img, Mat1i &imgLabels) {
 			//Case 4: nothing odd
 			for (int r = 0; r < imgLabels.rows; r += 2) {
 				// Get rows pointer
-				const uchar* const img_row = img.ptr<uchar>(r);
-				const uchar* const img_row_fol = (uchar *)(((char *)img_row) + img.step.p[0]);
+				const auto img_row = imageRow(img, r);
+				const auto img_row_fol = imageRow(img, r + 1);
 
-				uint* const imgLabels_row = imgLabels.ptr<uint>(r);
-				uint* const imgLabels_row_fol = (uint *)(((char *)imgLabels_row) + imgLabels.step.p[0]);
+				const auto imgLabels_row = labelsRow(imgLabels, r);
+				const auto imgLabels_row_fol = labelsRow(imgLabels, r + 1);
 				// Get rows pointer
 				for (int c = 0; c<imgLabels.cols; c += 2) {
 					int iLabel = imgLabels_row[c];
@@ -2170,888 +2323,284 @@ int BBDT_OPT(const Mat1b &img, Mat1i &imgLabels) {
 			}
 		}//END case 4
 	}
+}
 
-	fastFree(P);
-	return nLabel;
+template <typename SolverT>
+int BBDT_OPT_UF(const Mat1b &img, Mat1i &imgLabels) {
+
+	imgLabels = cv::Mat1i(img.size());
+	labelTracker tracker;
+	return labelBlocks<SolverT>(img.rows, img.cols,
+		[&](SolverT &P, uint &lunique) { firstScanBBDT_OPT(img, imgLabels, P, lunique, tracker); },
+		[&](SolverT &P, uint, uint nLabel) {
+			secondScanBBDT_OPT(img, imgLabels, P);
+			return nLabel;
+		});
+}
+
+int BBDT_OPT(const Mat1b &img, Mat1i &imgLabels) {
+	return BBDT_OPT_UF<ufSuzuki>(img, imgLabels);
+}
+
+template int BBDT_OPT_UF<ufSuzuki>(const Mat1b &img, Mat1i &imgLabels);
+template int BBDT_OPT_UF<ufHalving>(const Mat1b &img, Mat1i &imgLabels);
+template int BBDT_OPT_UF<ufSplitting>(const Mat1b &img, Mat1i &imgLabels);
+template int BBDT_OPT_UF<ufRank>(const Mat1b &img, Mat1i &imgLabels);
+template int BBDT_OPT_UF<ufSize>(const Mat1b &img, Mat1i &imgLabels);
+template int BBDT_OPT_UF<ufRem>(const Mat1b &img, Mat1i &imgLabels);
+template int BBDT_OPT_UF<ufLists>(const Mat1b &img, Mat1i &imgLabels);
+
+int BBDT_OPT_AREA(const Mat1b &img, Mat1i &imgLabels, uint min_area) {
+
+	imgLabels = cv::Mat1i(img.size());
+	areaTracker tracker(img, blockLabelsBound(img.rows, img.cols), 2);
+	return labelBlocks<ufSuzuki>(img.rows, img.cols,
+		[&](ufSuzuki &P, uint &lunique) { firstScanBBDT_OPT(img, imgLabels, P, lunique, tracker); },
+		[&](ufSuzuki &P, uint lunique, uint nLabel) {
+			nLabel = filterAreas(P, lunique, nLabel, tracker.areas, min_area);
+			secondScanBBDT_OPT(img, imgLabels, P);
+			return nLabel;
+		});
+}
+
+int BBDT_OPT_THR(const Mat1b &grey, Mat1i &imgLabels, uchar thresh, int cmp) {
+
+	const thresholdImage img(grey, thresh, cmp);
+
+	imgLabels = cv::Mat1i(img.rows, img.cols);
+	labelTracker tracker;
+	return labelBlocks<ufSuzuki>(img.rows, img.cols,
+		[&](ufSuzuki &P, uint &lunique) { firstScanBBDT_OPT(img, imgLabels, P, lunique, tracker); },
+		[&](ufSuzuki &P, uint, uint nLabel) {
+			secondScanBBDT_OPT(img, imgLabels, P);
+			return nLabel;
+		});
 }
 
+// Append the pixel in column x, labeled 'label', to the open run of a row (label 0 is background). 
+// Finished runs are moved to 'runs'.
 inline static
-void firstScanBBDT_MEM(memMat<uchar> &img, memMat<int>& imgLabels, memVector<uint> &P, uint &lunique) {
-	int w(img.cols), h(img.rows);
+void extendRun(vector<labelRun>& runs, labelRun& run, int x, uint label) {
+	if (label == run.label) {
+		if (label)
+			run.length++;
+		return;
+	}
+	if (run.label)
+		runs.push_back(run);
+	run.start = x;
+	run.length = 1;
+	run.label = label;
+}
 
-	for (int r = 0; r<h; r += 2) {
+// Second scan of BBDT_OPT producing runs instead of a dense image. Labels of the blocks are read from the 
+// compact block matrix and the two rows of every block row are encoded together: runs of the second one 
+// are collected apart and appended after the runs of the first one.
+template <typename ImgT, typename EquivT>
+inline static
+void secondScanBBDT_OPT_RLE(ImgT &img, blockLabels& imgLabels, EquivT &P, labelRuns& runs, vector<labelRun>& runs_fol) {
+	const int w(img.cols), h(img.rows);
+	runs.reset(h, w);
+
+	for (int r = 0; r < h; r += 2) {
+		// Get rows pointer
+		const auto img_row = imageRow(img, r);
+		const auto img_row_fol = imageRow(img, r + 1);
+		const auto imgLabels_row = labelsRow(imgLabels, r);
+		const bool fol = r + 1 < h;
+
+		labelRun run = { 0, 0, 0 }, run_fol = { 0, 0, 0 }; // Open runs (label 0 if none)
+		runs_fol.clear();
 		for (int c = 0; c < w; c += 2) {
+			uint iLabel = imgLabels_row[c];
+			if (iLabel > 0)
+				iLabel = P[iLabel];
+			for (int x = c; x < c + 2 && x < w; ++x) {
+				extendRun(runs.runs, run, x, img_row[x] > 0 ? iLabel : 0);
+				if (fol)
+					extendRun(runs_fol, run_fol, x, img_row_fol[x] > 0 ? iLabel : 0);
+			}
+		}
 
-			// We work with 2x2 blocks
-			// +-+-+-+
-			// |P|Q|R|
-			// +-+-+-+
-			// |S|X|
-			// +-+-+
+		if (run.label)
+			runs.runs.push_back(run);
+		runs.endRow();
+		if (fol){
+			if (run_fol.label)
+				runs_fol.push_back(run_fol);
+			runs.runs.insert(runs.runs.end(), runs_fol.begin(), runs_fol.end());
+			runs.endRow();
+		}
+	}
+}
 
-			// The pixels are named as follows
-			// +---+---+---+
-			// |a b|c d|e f|
-			// |g h|i j|k l|
-			// +---+---+---+
-			// |m n|o p|
-			// |q r|s t|
-			// +---+---+
+int BBDT_OPT_RLE(const Mat1b &img, labelRuns &runs) {
+
+	// Provisional labels are needed only for the blocks
+	blockLabels imgLabels(img.size());
+	labelTracker tracker;
+	vector<labelRun> runs_fol;
+	return labelBlocks<ufSuzuki>(img.rows, img.cols,
+		[&](ufSuzuki &P, uint &lunique) { firstScanBBDT_OPT(img, imgLabels, P, lunique, tracker); },
+		[&](ufSuzuki &P, uint, uint nLabel) {
+			secondScanBBDT_OPT_RLE(img, imgLabels, P, runs, runs_fol);
+			return nLabel;
+		});
+}
 
-			// Pixels a, f, l, q are not needed, since we need to understand the 
-			// the connectivity between these blocks and those pixels only metter
-			// when considering the outer connectivities
+int BBDT_OPT_BOXES(const Mat1b &img, vector<Rect> &boxes) {
+
+	// Provisional labels are needed only for the blocks, and the label image is never produced
+	blockLabels imgLabels(img.size());
+	boxTracker tracker(img, blockLabelsBound(img.rows, img.cols), 2);
+	return labelBlocks<ufSuzuki>(img.rows, img.cols,
+		[&](ufSuzuki &P, uint &lunique) { firstScanBBDT_OPT(img, imgLabels, P, lunique, tracker); },
+		[&](ufSuzuki &P, uint lunique, uint nLabel) {
+			mergeBoxes(P, lunique, nLabel, tracker, boxes);
+			return nLabel;
+		});
+}
 
-			// A bunch of defines used to check if the pixels are foreground, 
-			// without going outside the image limits.
+int BBDT_OPT_RLE_DENSE(const Mat1b &img, Mat1i &imgLabels) {
+	labelRuns runs;
+	int nLabel = BBDT_OPT_RLE(img, runs);
+	runs.toDense(imgLabels);
+	return nLabel;
+}
 
-#define condition_b c-1>=0 && r-2>=0 && img(r-2, c-1)>0
-#define condition_c r-2>=0 && img(r-2, c)>0
-#define condition_d c+1<w && r-2>=0 && img(r-2, c+1)>0
-#define condition_e c+2<w && r-2>=0 && img(r-2, c+2)>0
+int BBDT_OPT_AREA_ALL(const Mat1b &img, Mat1i &imgLabels) {
+	return BBDT_OPT_AREA(img, imgLabels, 0);
+}
 
-#define condition_g c-2>=0 && r-1>=0 && img(r-1, c-2)>0
-#define condition_h c-1>=0 && r-1>=0 && img(r-1, c-1)>0
-#define condition_i r-1>=0 && img(r-1, c)>0
-#define condition_j c+1<w && r-1>=0 && img(r-1, c+1)>0
-#define condition_k c+2<w && r-1>=0 && img(r-1, c+2)>0
+int BBDT_OPT_THR_BINARY(const Mat1b &img, Mat1i &imgLabels) {
+	return BBDT_OPT_THR(img, imgLabels, 0, CMP_GT);
+}
 
-#define condition_m c-2>=0 && img(r, c-2)>0
-#define condition_n c-1>=0 && img(r, c-1)>0
-#define condition_o img(r,c)>0
-#define condition_p c+1<w && img(r,c+1)>0
+int BBDT_OPT_BOXES_CHECK(const Mat1b &img, Mat1i &imgLabels) {
+	const int nLabel = BBDT_OPT(img, imgLabels);
+	vector<Rect> boxes, expected;
+	labelsBoxes(imgLabels, nLabel, expected);
+	if (BBDT_OPT_BOXES(img, boxes) != nLabel || boxes != expected)
+		return 0;
+	return nLabel;
+}
 
-#define condition_r c-1>=0 && r+1<h && img(r+1, c-1)>0
-#define condition_s r+1<h && img(r+1, c)>0
-#define condition_t c+1<w && r+1<h && img(r+1, c+1)>0
+// Tracker which records the block where every provisional label is created
+struct startsTracker : labelTracker{
+	vector<Point> blocks;
 
-			// This is a decision tree which allows to choose which action to 
-			// perform, checking as few conditions as possible.
-			// Actions are available after the tree.
+	void newLabel(uint label, int r, int c) {
+		blocks[label] = Point(c, r);
+	}
+};
 
-			if (condition_o) {
-				if (condition_n) {
-					if (condition_j) {
-						if (condition_i) {
-							goto action_6;
-						}
-						else {
-							if (condition_c) {
-								if (condition_h) {
-									goto action_6;
-								}
-								else {
-									if (condition_g) {
-										if (condition_b) {
-											goto action_6;
-										}
-										else {
-											goto action_11;
-										}
-									}
-									else {
-										goto action_11;
-									}
-								}
-							}
-							else {
-								goto action_11;
-							}
-						}
-					}
-					else {
-						if (condition_p) {
-							if (condition_k) {
-								if (condition_d) {
-									if (condition_i) {
-										goto action_6;
-									}
-									else {
-										if (condition_c) {
-											if (condition_h) {
-												goto action_6;
-											}
-											else {
-												if (condition_g) {
-													if (condition_b) {
-														goto action_6;
-													}
-													else {
-														goto action_12;
-													}
-												}
-												else {
-													goto action_12;
-												}
-											}
-										}
-										else {
-											goto action_12;
-										}
-									}
-								}
-								else {
-									goto action_12;
-								}
-							}
-							else {
-								goto action_6;
-							}
-						}
-						else {
-							goto action_6;
-						}
-					}
-				}
-				else {
-					if (condition_r) {
-						if (condition_j) {
-							if (condition_m) {
-								if (condition_h) {
-									if (condition_i) {
-										goto action_6;
-									}
-									else {
-										if (condition_c) {
-											goto action_6;
-										}
-										else {
-											goto action_11;
-										}
-									}
-								}
-								else {
-									if (condition_g) {
-										if (condition_b) {
-											if (condition_i) {
-												goto action_6;
-											}
-											else {
-												if (condition_c) {
-													goto action_6;
-												}
-												else {
-													goto action_11;
-												}
-											}
-										}
-										else {
-											goto action_11;
-										}
-									}
-									else {
-										goto action_11;
-									}
-								}
-							}
-							else {
-								if (condition_i) {
-									goto action_11;
-								}
-								else {
-									if (condition_h) {
-										if (condition_c) {
-											goto action_11;
-										}
-										else {
-											goto action_14;
-										}
-									}
-									else {
-										goto action_11;
-									}
-								}
-							}
-						}
-						else {
-							if (condition_p) {
-								if (condition_k) {
-									if (condition_m) {
-										if (condition_h) {
-											if (condition_d) {
-												if (condition_i) {
-													goto action_6;
-												}
-												else {
-													if (condition_c) {
-														goto action_6;
-													}
-													else {
-														goto action_12;
-													}
-												}
-											}
-											else {
-												goto action_12;
-											}
-										}
-										else {
-											if (condition_d) {
-												if (condition_g) {
-													if (condition_b) {
-														if (condition_i) {
-															goto action_6;
-														}
-														else {
-															if (condition_c) {
-																goto action_6;
-															}
-															else {
-																goto action_12;
-															}
-														}
-													}
-													else {
-														goto action_12;
-													}
-												}
-												else {
-													goto action_12;
-												}
-											}
-											else {
-												if (condition_i) {
-													if (condition_g) {
-														if (condition_b) {
-															goto action_12;
-														}
-														else {
-															goto action_16;
-														}
-													}
-													else {
-														goto action_16;
-													}
-												}
-												else {
-													goto action_12;
-												}
-											}
-										}
-									}
-									else {
-										if (condition_i) {
-											if (condition_d) {
-												goto action_12;
-											}
-											else {
-												goto action_16;
-											}
-										}
-										else {
-											if (condition_h) {
-												if (condition_d) {
-													if (condition_c) {
-														goto action_12;
-													}
-													else {
-														goto action_15;
-													}
-												}
-												else {
-													goto action_15;
-												}
-											}
-											else {
-												goto action_12;
-											}
-										}
-									}
-								}
-								else {
-									if (condition_h) {
-										if (condition_m) {
-											goto action_6;
-										}
-										else {
-											goto action_9;
-										}
-									}
-									else {
-										if (condition_i) {
-											if (condition_m) {
-												if (condition_g) {
-													if (condition_b) {
-														goto action_6;
-													}
-													else {
-														goto action_11;
-													}
-												}
-												else {
-													goto action_11;
-												}
-											}
-											else {
-												goto action_11;
-											}
-										}
-										else {
-											goto action_6;
-										}
-									}
-								}
-							}
-							else {
-								if (condition_h) {
-									if (condition_m) {
-										goto action_6;
-									}
-									else {
-										goto action_9;
-									}
-								}
-								else {
-									if (condition_i) {
-										if (condition_m) {
-											if (condition_g) {
-												if (condition_b) {
-													goto action_6;
-												}
-												else {
-													goto action_11;
-												}
-											}
-											else {
-												goto action_11;
-											}
-										}
-										else {
-											goto action_11;
-										}
-									}
-									else {
-										goto action_6;
-									}
-								}
-							}
-						}
-					}
-					else {
-						if (condition_j) {
-							if (condition_i) {
-								goto action_4;
-							}
-							else {
-								if (condition_h) {
-									if (condition_c) {
-										goto action_4;
-									}
-									else {
-										goto action_7;
-									}
-								}
-								else {
-									goto action_4;
-								}
-							}
-						}
-						else {
-							if (condition_p) {
-								if (condition_k) {
-									if (condition_i) {
-										if (condition_d) {
-											goto action_5;
-										}
-										else {
-											goto action_10;
-										}
-									}
-									else {
-										if (condition_h) {
-											if (condition_d) {
-												if (condition_c) {
-													goto action_5;
-												}
-												else {
-													goto action_8;
-												}
-											}
-											else {
-												goto action_8;
-											}
-										}
-										else {
-											goto action_5;
-										}
-									}
-								}
-								else {
-									if (condition_i) {
-										goto action_4;
-									}
-									else {
-										if (condition_h) {
-											goto action_3;
-										}
-										else {
-											goto action_2;
-										}
-									}
-								}
-							}
-							else {
-								if (condition_i) {
-									goto action_4;
-								}
-								else {
-									if (condition_h) {
-										goto action_3;
-									}
-									else {
-										goto action_2;
-									}
-								}
-							}
-						}
-					}
-				}
-			}
-			else {
-				if (condition_s) {
-					if (condition_p) {
-						if (condition_n) {
-							if (condition_j) {
-								if (condition_i) {
-									goto action_6;
-								}
-								else {
-									if (condition_c) {
-										if (condition_h) {
-											goto action_6;
-										}
-										else {
-											if (condition_g) {
-												if (condition_b) {
-													goto action_6;
-												}
-												else {
-													goto action_11;
-												}
-											}
-											else {
-												goto action_11;
-											}
-										}
-									}
-									else {
-										goto action_11;
-									}
-								}
-							}
-							else {
-								if (condition_k) {
-									if (condition_d) {
-										if (condition_i) {
-											goto action_6;
-										}
-										else {
-											if (condition_c) {
-												if (condition_h) {
-													goto action_6;
-												}
-												else {
-													if (condition_g) {
-														if (condition_b) {
-															goto action_6;
-														}
-														else {
-															goto action_12;
-														}
-													}
-													else {
-														goto action_12;
-													}
-												}
-											}
-											else {
-												goto action_12;
-											}
-										}
-									}
-									else {
-										goto action_12;
-									}
-								}
-								else {
-									goto action_6;
-								}
-							}
-						}
-						else {
-							if (condition_r) {
-								if (condition_j) {
-									if (condition_m) {
-										if (condition_h) {
-											if (condition_i) {
-												goto action_6;
-											}
-											else {
-												if (condition_c) {
-													goto action_6;
-												}
-												else {
-													goto action_11;
-												}
-											}
-										}
-										else {
-											if (condition_g) {
-												if (condition_b) {
-													if (condition_i) {
-														goto action_6;
-													}
-													else {
-														if (condition_c) {
-															goto action_6;
-														}
-														else {
-															goto action_11;
-														}
-													}
-												}
-												else {
-													goto action_11;
-												}
-											}
-											else {
-												goto action_11;
-											}
-										}
-									}
-									else {
-										goto action_11;
-									}
-								}
-								else {
-									if (condition_k) {
-										if (condition_d) {
-											if (condition_m) {
-												if (condition_h) {
-													if (condition_i) {
-														goto action_6;
-													}
-													else {
-														if (condition_c) {
-															goto action_6;
-														}
-														else {
-															goto action_12;
-														}
-													}
-												}
-												else {
-													if (condition_g) {
-														if (condition_b) {
-															if (condition_i) {
-																goto action_6;
-															}
-															else {
-																if (condition_c) {
-																	goto action_6;
-																}
-																else {
-																	goto action_12;
-																}
-															}
-														}
-														else {
-															goto action_12;
-														}
-													}
-													else {
-														goto action_12;
-													}
-												}
-											}
-											else {
-												goto action_12;
-											}
-										}
-										else {
-											if (condition_i) {
-												if (condition_m) {
-													if (condition_h) {
-														goto action_12;
-													}
-													else {
-														if (condition_g) {
-															if (condition_b) {
-																goto action_12;
-															}
-															else {
-																goto action_16;
-															}
-														}
-														else {
-															goto action_16;
-														}
-													}
-												}
-												else {
-													goto action_16;
-												}
-											}
-											else {
-												goto action_12;
-											}
-										}
-									}
-									else {
-										if (condition_i) {
-											if (condition_m) {
-												if (condition_h) {
-													goto action_6;
-												}
-												else {
-													if (condition_g) {
-														if (condition_b) {
-															goto action_6;
-														}
-														else {
-															goto action_11;
-														}
-													}
-													else {
-														goto action_11;
-													}
-												}
-											}
-											else {
-												goto action_11;
-											}
-										}
-										else {
-											goto action_6;
-										}
-									}
-								}
-							}
-							else {
-								if (condition_j) {
-									goto action_4;
-								}
-								else {
-									if (condition_k) {
-										if (condition_i) {
-											if (condition_d) {
-												goto action_5;
-											}
-											else {
-												goto action_10;
-											}
-										}
-										else {
-											goto action_5;
-										}
-									}
-									else {
-										if (condition_i) {
-											goto action_4;
-										}
-										else {
-											goto action_2;
-										}
-									}
-								}
-							}
-						}
-					}
-					else {
-						if (condition_r) {
-							goto action_6;
-						}
-						else {
-							if (condition_n) {
-								goto action_6;
-							}
-							else {
-								goto action_2;
-							}
-						}
-					}
-				}
-				else {
-					if (condition_p) {
-						if (condition_j) {
-							goto action_4;
-						}
-						else {
-							if (condition_k) {
-								if (condition_i) {
-									if (condition_d) {
-										goto action_5;
-									}
-									else {
-										goto action_10;
-									}
-								}
-								else {
-									goto action_5;
-								}
-							}
-							else {
-								if (condition_i) {
-									goto action_4;
-								}
-								else {
-									goto action_2;
-								}
-							}
-						}
-					}
-					else {
-						if (condition_t) {
-							goto action_2;
-						}
-						else {
-							goto action_1; 
-						}
-					}
-				}
-			}
+// Tracker which also records the possible first pixels of holes (background pixels with foreground above and on 
+// the left, see traceContours), in row major order: those of the lower row of a pair of rows are kept apart until 
+// the next pair. Only the top left pixel of a background block can be one of them, the others have background 
+// above or on the left.
+struct holeStartsTracker : startsTracker{
+	const Mat1b &img;
+	vector<Point> hole_starts, lower;
 
-			// Actions: the blocks label are provisionally stored in the top left 
-			// pixel of the block in the labels image
+	holeStartsTracker(const Mat1b &img) : img(img) {}
 
-			action_1:	//Action_1: No action (the block has no foreground pixels)
-				imgLabels(r,c) = 0;
-				continue;
-			action_2:	//Action_2: New label (the block has foreground pixels and is not connected to anything else)
-				imgLabels(r, c) = lunique;
-				P[lunique] = lunique;
-				lunique = lunique + 1;
-				continue;
-			action_3:	//Action_3: Assign label of block P
-				imgLabels(r,c) = imgLabels(r - 2, c - 2);
-				continue;
-			action_4:	//Action_4: Assign label of block Q 
-				imgLabels(r, c) = imgLabels(r - 2, c);
-				continue;
-			action_5:	//Action_5: Assign label of block R
-				imgLabels(r,c) = imgLabels(r - 2, c + 2);
-				continue;			
-			action_6:	//Action_6: Assign label of block S
-				imgLabels(r,c) = imgLabels(r, c - 2);
-				continue;			
-			action_7:	//Action_7: Merge labels of block P and Q
-				imgLabels(r, c) = set_union(P, (uint)imgLabels(r - 2, c - 2), (uint)imgLabels(r - 2, c));
-				continue;			
-			action_8:	//Action_8: Merge labels of block P and R
-				imgLabels(r, c) = set_union(P, (uint)imgLabels(r - 2, c - 2), (uint)imgLabels(r - 2, c + 2));
-				continue;
-			action_9:	// Action_9 Merge labels of block P and S
-				imgLabels(r, c) = set_union(P, (uint)imgLabels(r - 2, c - 2), (uint)imgLabels(r, c - 2));
-				continue;
-			action_10:	// Action_10 Merge labels of block Q and R
-				imgLabels(r, c) = set_union(P, (uint)imgLabels(r - 2, c), (uint)imgLabels(r - 2, c + 2));
-				continue;
-			action_11:	//Action_11: Merge labels of block Q and S
-				imgLabels(r, c) = set_union(P, (uint)imgLabels(r - 2, c), (uint)imgLabels(r, c - 2));
-				continue;
-			action_12:	//Action_12: Merge labels of block R and S
-				imgLabels(r, c) = set_union(P, (uint)imgLabels(r - 2, c + 2), (uint)imgLabels(r, c - 2));
-				continue;
-			action_14:	//Action_14: Merge labels of block P, Q and S
-				imgLabels(r, c) = set_union(P, set_union(P, (uint)imgLabels(r - 2, c - 2), (uint)imgLabels(r - 2, c)), (uint)imgLabels(r, c - 2));
-				continue;
-			action_15:	//Action_15: Merge labels of block P, R and S
-				imgLabels(r, c) = set_union(P, set_union(P, (uint)imgLabels(r - 2, c - 2), (uint)imgLabels(r - 2, c + 2)), (uint)imgLabels(r, c - 2));
-				continue;
-			action_16:	//Action_16: labels of block Q, R and S
-				imgLabels(r, c) = set_union(P, set_union(P, (uint)imgLabels(r - 2, c), (uint)imgLabels(r - 2, c + 2)), (uint)imgLabels(r, c - 2));
-				continue;
-		}
+	void holeStart(vector<Point>& starts, int r, int c) {
+		if (r > 0 && c > 0 && r + 1 < img.rows && c + 1 < img.cols && img(r, c) == 0 && img(r - 1, c) > 0 && img(r, c - 1) > 0)
+			starts.push_back(Point(c, r));
 	}
 
-#undef condition_b
-#undef condition_c
-#undef condition_d
-#undef condition_e
+	template <typename RowT>
+	void labeled(const RowT& labels_row, int r, int c) {
+		if (c == 0)
+			flush();
+		holeStart(hole_starts, r, c);
+		if (labels_row[c] > 0) {
+			holeStart(hole_starts, r, c + 1);
+			holeStart(lower, r + 1, c);
+			holeStart(lower, r + 1, c + 1);
+		}
+	}
 
-#undef condition_g
-#undef condition_h
-#undef condition_i
-#undef condition_j
-#undef condition_k
+	void flush() {
+		hole_starts.insert(hole_starts.end(), lower.begin(), lower.end());
+		lower.clear();
+	}
+};
 
-#undef condition_m
-#undef condition_n
-#undef condition_o
-#undef condition_p
+// BBDT_OPT recording the first pixel of every component with the tracker (a startsTracker)
+template <typename TrackerT>
+static int BBDT_OPT_STARTS(const Mat1b &img, Mat1i &imgLabels, vector<Point> &starts, TrackerT &tracker) {
 
-#undef condition_r
-#undef condition_s
-#undef condition_t
+	imgLabels = cv::Mat1i(img.size());
+	tracker.blocks.resize(blockLabelsBound(img.rows, img.cols));
+	return labelBlocks<ufSuzuki>(img.rows, img.cols,
+		[&](ufSuzuki &P, uint &lunique) { firstScanBBDT_OPT(img, imgLabels, P, lunique, tracker); },
+		[&](ufSuzuki &P, uint lunique, uint nLabel) {
+			// The root of every component is its smallest provisional label, created in the first block of the component 
+			// in row major order. The first foreground pixel of that block has no pixels of the component above it, so 
+			// its north neighbor is outside the component: contours are traced from it.
+			starts.assign(nLabel, Point(-1, -1));
+			for (uint l = 1; l < lunique; ++l) {
+				Point& start = starts[P[l]];
+				if (start.x >= 0)
+					continue;
+				const Point block = tracker.blocks[l];
+				const int r = (block.y + 1 < img.rows && img(block.y, block.x) == 0 && (block.x + 1 >= img.cols || img(block.y, block.x + 1) == 0)) ? block.y + 1 : block.y;
+				start = Point(img(r, block.x) > 0 ? block.x : block.x + 1, r);
+			}
 
+			secondScanBBDT_OPT(img, imgLabels, P);
+			return nLabel;
+		});
 }
 
-int BBDT_MEM(const Mat1b &img_origin, vector<unsigned long int> &accesses) {
+int BBDT_OPT_CONTOURS(const Mat1b &img, Mat1i &imgLabels, vector<vector<Point>> &contours) {
+	startsTracker tracker;
+	vector<Point> starts;
+	const int nLabel = BBDT_OPT_STARTS(img, imgLabels, starts, tracker);
+	traceOuterContours(imgLabels, starts, contours);
+	return nLabel;
+}
 
-	//A quick and dirty upper bound for the maximimum number of labels.
-	const size_t Plength = img_origin.rows*img_origin.cols / 4;
-	
-	//Tree of labels
-	memMat<uchar> img(img_origin); 
-	memMat<int> imgLabels(img_origin.size());
-	memVector<uint> P(Plength);
-	
-	//Background
-	P[0] = 0;
-	uint lunique = 1;
+int BBDT_OPT_CONTOURS(const Mat1b &img, Mat1i &imgLabels, vector<vector<Point>> &contours, vector<vector<Point>> &holes, vector<uint> &hole_parents) {
+	holeStartsTracker tracker(img);
+	vector<Point> starts;
+	const int nLabel = BBDT_OPT_STARTS(img, imgLabels, starts, tracker);
+	tracker.flush();
+	traceContours(imgLabels, starts, tracker.hole_starts, contours, holes, hole_parents);
+	return nLabel;
+}
 
-	firstScanBBDT_MEM(img, imgLabels, P, lunique);
+int BBDT_OPT_CONTOURS_CHECK(const Mat1b &img, Mat1i &imgLabels) {
+	vector<vector<Point>> contours, holes;
+	vector<uint> hole_parents;
+	const int nLabel = BBDT_OPT_CONTOURS(img, imgLabels, contours, holes, hole_parents);
+	if (!contoursMatchLabels(imgLabels, nLabel, contours, holes, hole_parents))
+		return 0;
+	return nLabel;
+}
 
-	uint nLabel = flattenL(P, lunique);
+int BBDT_MEM(const Mat1b &img_origin, vector<unsigned long int> &accesses) {
 
-	//Second scan
-	for (int r = 0; r < img_origin.rows; r += 2) {
-		for (int c = 0; c < img_origin.cols; c += 2) {
-			int iLabel = imgLabels(r,c);
-			if (iLabel>0) {
-				iLabel = P[iLabel];
-				if (img(r,c) > 0)
-					imgLabels(r,c) = iLabel;
-				else
-					imgLabels(r, c) = 0;
-				if (c + 1 < img_origin.cols) {
-					if (img(r, c + 1) > 0)
-						imgLabels(r, c + 1) = iLabel;
-					else
-						imgLabels(r, c + 1) = 0;
-					if (r + 1 < img_origin.rows) {
-						if (img(r + 1, c) > 0)
-							imgLabels(r + 1, c) = iLabel;
-						else
-							imgLabels(r + 1, c) = 0;
-						if (img(r + 1, c + 1) > 0)
-							imgLabels(r + 1, c + 1) = iLabel;
-						else
-							imgLabels(r + 1, c + 1) = 0;
-					}
-				}
-				else if (r + 1 < img_origin.rows) {
-					if (img(r + 1, c) > 0)
-						imgLabels(r + 1, c) = iLabel;
-					else
-						imgLabels(r + 1, c) = 0;
-				}
-			}
-			else {
-				imgLabels(r , c) = 0;
-				if (c + 1 < img_origin.cols) {
-					imgLabels(r, c + 1) = 0;
-					if (r + 1 < img_origin.rows) {
-						imgLabels(r + 1, c) = 0;
-						imgLabels(r + 1, c + 1) = 0;
-					}
-				}
-				else if (r + 1 < img_origin.rows) {
-					imgLabels(r + 1, c) = 0;
-				}
-			}
-		}
-	}
+	memMat<uchar> img(img_origin, MD_BINARY_MAT); 
+	memMat<int> imgLabels(img_origin.size(), MD_LABELED_MAT);
+	//Tree of labels
+	memVector<uint> P(blockLabelsBound(img_origin.rows, img_origin.cols), MD_EQUIVALENCE_VEC);
+
+	// Same code of BBDT_OPT, instantiated on the counting data structures
+	labelTracker tracker;
+	const int nLabel = labelBlocks(P,
+		[&](memVector<uint> &P, uint &lunique) {
+			memoryPhase("first_scan");
+			firstScanBBDT_OPT(img, imgLabels, P, lunique, tracker);
+			// Flattening follows
+			memoryPhase("flatten");
+		},
+		[&](memVector<uint> &P, uint, uint nLabel) {
+			memoryPhase("second_scan");
+			secondScanBBDT_OPT(img, imgLabels, P);
+			return nLabel;
+		});
 
 	// Store total accesses in the output vector 'accesses'
 	accesses = vector<unsigned long int>((int)MD_SIZE, 0);
@@ -3060,7 +2609,5 @@ int BBDT_MEM(const Mat1b &img_origin, vector<unsigned long int> &accesses) {
 	accesses[MD_LABELED_MAT] = (unsigned long int)imgLabels.getTotalAcesses();
 	accesses[MD_EQUIVALENCE_VEC] = (unsigned long int)P.getTotalAcesses();
 
-	//a = imgLabels.getImage(); 
-
 	return nLabel;
 }
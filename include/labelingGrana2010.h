@@ -30,6 +30,8 @@
 #include "opencv2/opencv.hpp"
 //#include "memoryTester.h"
 #include "equivalenceSolverSuzuki.h"
+#include "equivalenceSolverPolicies.h"
+#include "labelRuns.h"
 
 // Readable version of Grana's algorithm
 int BBDT(const cv::Mat1b &img, cv::Mat1i &imgLabels);
@@ -37,7 +39,58 @@ int BBDT(const cv::Mat1b &img, cv::Mat1i &imgLabels);
 // Optimized version of Grana's algorithm
 int BBDT_OPT(const cv::Mat1b &img, cv::Mat1i &imgLabels);
 
-//  Version of Grana's algorithm which provides memory accesses details
+// Optimized version of Grana's algorithm with the union-find strategy 'SolverT' (see equivalenceSolverPolicies.h), 
+// instantiated for all the solvers of that header
+template <typename SolverT>
+int BBDT_OPT_UF(const cv::Mat1b &img, cv::Mat1i &imgLabels);
+
+// Optimized version of Grana's algorithm on a greyscale image, whose foreground pixels are those for which 
+// 'cmp' (cv::CMP_GT, CMP_GE, CMP_LT, CMP_LE, CMP_EQ or CMP_NE) holds between their value and 'thresh': the 
+// threshold is evaluated while labeling (see thresholdImage), without a binary copy of the image. An unknown 
+// comparison raises cv::Exception (cv::Error::StsBadArg).
+int BBDT_OPT_THR(const cv::Mat1b &grey, cv::Mat1i &imgLabels, uchar thresh, int cmp = cv::CMP_GT);
+
+// Optimized version of Grana's algorithm which removes the components with less than 'min_area' pixels 
+// (e.g. noise): areas of the provisional labels are collected by the first scan and merged after flattening, 
+// so the second scan outputs the other components already labeled contiguously
+int BBDT_OPT_AREA(const cv::Mat1b &img, cv::Mat1i &imgLabels, uint min_area);
+
+// Optimized version of Grana's algorithm which outputs runs of labels (see labelRuns): the second scan 
+// encodes runs directly, and provisional labels are stored only for 2x2 blocks
+int BBDT_OPT_RLE(const cv::Mat1b &img, labelRuns &runs);
+
+// Optimized version of Grana's algorithm which also extracts the outer contour of every component (see 
+// traceOuterContours): the first pixel of every component is recorded by the first scan, so contours are traced 
+// without searching the image. 'contours' is indexed by label (contours[0] is empty).
+int BBDT_OPT_CONTOURS(const cv::Mat1b &img, cv::Mat1i &imgLabels, std::vector<std::vector<cv::Point>> &contours);
+
+// BBDT_OPT_CONTOURS which also traces the contours of the holes (see traceContours): the first scan also records 
+// the pixels from which holes may start, so holes are found without visiting the background. 'hole_parents' holds 
+// the label of the component enclosing every hole.
+int BBDT_OPT_CONTOURS(const cv::Mat1b &img, cv::Mat1i &imgLabels, std::vector<std::vector<cv::Point>> &contours, std::vector<std::vector<cv::Point>> &holes, std::vector<uint> &hole_parents);
+
+// Optimized version of Grana's algorithm which computes only the bounding boxes of the components, without 
+// producing the label image (e.g. for OCR segmentation). 'boxes' is indexed by label (boxes[0] is empty).
+int BBDT_OPT_BOXES(const cv::Mat1b &img, std::vector<cv::Rect> &boxes);
+
+// BBDT_OPT_RLE followed by conversion to a dense image, to check and compare it with the other algorithms
+int BBDT_OPT_RLE_DENSE(const cv::Mat1b &img, cv::Mat1i &imgLabels);
+
+// BBDT_OPT_AREA keeping every component (min_area 0), to check it with the other algorithms
+int BBDT_OPT_AREA_ALL(const cv::Mat1b &img, cv::Mat1i &imgLabels);
+
+// Labels of BBDT_OPT, to check BBDT_OPT_BOXES with the other algorithms: if BBDT_OPT_BOXES does not give the 
+// boxes of the components of those labels, 0 labels are returned so that the check fails
+int BBDT_OPT_BOXES_CHECK(const cv::Mat1b &img, cv::Mat1i &imgLabels);
+
+// BBDT_OPT_THR with the foreground of binary images (values greater than 0), to check it with the other algorithms
+int BBDT_OPT_THR_BINARY(const cv::Mat1b &img, cv::Mat1i &imgLabels);
+
+// Labels of BBDT_OPT_CONTOURS, to check it with the other algorithms: if its outer and hole contours do not match 
+// the labels (see contoursMatchLabels), 0 labels are returned so that the check fails
+int BBDT_OPT_CONTOURS_CHECK(const cv::Mat1b &img, cv::Mat1i &imgLabels);
+
+//  Version of Grana's algorithm which provides memory accesses details (BBDT_OPT instantiated on memMat/memVector)
 // 㷨ṩ㷨ڴĽͳƵĺںоĿǰȰٶ
 int BBDT_MEM(const cv::Mat1b &img, std::vector<unsigned long int> &accesses);
 //int BBDT_MEM(const cv::Mat1b &img, cv::Mat1i &a);
\ No newline at end of file
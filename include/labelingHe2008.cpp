@@ -0,0 +1,128 @@
+// Copyright(c) 2016 - Costantino Grana, Federico Bolelli, Lorenzo Baraldi and Roberto Vezzani
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// *Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+// 
+// * Neither the name of YACCLAB nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "labelingHe2008.h"
+#include "equivalenceSolverSuzuki.h"
+
+using namespace cv;
+using namespace std;
+
+// First scan: every run gets the provisional label of the runs of the previous row it is 8-connected with 
+// (runs overlapping it or touching it diagonally), merging their trees when there are more than one. Runs 
+// of the previous row are visited in order, so every run is compared only with its neighbors. 
+// Returns the number of provisional labels + 1.
+static uint firstScanRBTS(const binaryRuns &img, uint *P, vector<uint> &provisional) {
+	uint lunique = 1;
+
+	for (int r = 0; r < img.rows; ++r) {
+		size_t p = r > 0 ? img.row_begin[r - 1] : 0;
+		const size_t prev_end = img.row_begin[r];
+		for (size_t i = img.row_begin[r]; i < img.row_begin[r + 1]; ++i) {
+			const int start = img.runs[i].start, last = start + img.runs[i].length - 1;
+
+			// Skip runs of the previous row which end before the neighborhood of this one
+			while (p < prev_end && img.runs[p].start + img.runs[p].length < start)
+				++p;
+
+			uint label = 0;
+			for (size_t q = p; q < prev_end && img.runs[q].start <= last + 1; ++q)
+				label = label ? set_union(P, label, provisional[q]) : provisional[q];
+
+			// Runs of the same row which touch each other are the same component
+			if (i > img.row_begin[r] && img.runs[i - 1].start + img.runs[i - 1].length == start)
+				label = label ? set_union(P, label, provisional[i - 1]) : provisional[i - 1];
+
+			if (!label) {
+				// New label
+				P[lunique] = lunique;
+				label = lunique++;
+			}
+			provisional[i] = label;
+		}
+	}
+	return lunique;
+}
+
+// Labels the runs, leaving in 'provisional' the final label of every run
+static uint labelRunsRBTS(const binaryRuns &img, vector<uint> &provisional) {
+
+	// Every run may have its own label
+	const size_t Plength = img.runs.size() + 1;
+	//Tree of labels
+	uint *P = (uint *)fastMalloc(sizeof(uint)* Plength);
+	//Background
+	P[0] = 0;
+
+	provisional.resize(img.runs.size());
+	uint lunique = firstScanRBTS(img, P, provisional);
+	COUNT_EVENTS(CT_PROVISIONAL_LABELS, lunique - 1);
+
+	uint nLabel = flattenL(P, lunique);
+
+	for (size_t i = 0; i < provisional.size(); ++i)
+		provisional[i] = P[provisional[i]];
+
+	fastFree(P);
+	return nLabel;
+}
+
+int RBTS(const binaryRuns &img, labelRuns &runs) {
+
+	vector<uint> labels;
+	uint nLabel = labelRunsRBTS(img, labels);
+
+	runs.rows = img.rows;
+	runs.cols = img.cols;
+	runs.row_begin = img.row_begin;
+	runs.runs.resize(img.runs.size());
+	for (size_t i = 0; i < img.runs.size(); ++i)
+		runs.runs[i] = { img.runs[i].start, img.runs[i].length, labels[i] };
+
+	return nLabel;
+}
+
+int RBTS(const binaryRuns &img, Mat1i &imgLabels) {
+
+	vector<uint> labels;
+	uint nLabel = labelRunsRBTS(img, labels);
+
+	imgLabels = Mat1i(img.rows, img.cols, 0);
+	for (int r = 0; r < img.rows; ++r) {
+		uint * const imgLabels_row = imgLabels.ptr<uint>(r);
+		for (size_t i = img.row_begin[r]; i < img.row_begin[r + 1]; ++i)
+			fill(imgLabels_row + img.runs[i].start, imgLabels_row + img.runs[i].start + img.runs[i].length, labels[i]);
+	}
+
+	return nLabel;
+}
+
+int RBTS_OPT(const Mat1b &img, Mat1i &imgLabels) {
+	binaryRuns runs;
+	runs.encode(img);
+	return RBTS(runs, imgLabels);
+}
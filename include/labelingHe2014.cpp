@@ -27,6 +27,9 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "labelingHe2014.h"
+#include "equivalenceSolverSuzuki.h"
+#include "labelingAccess.h"
+#include "componentFeatures.h"
 
 using namespace cv;
 using namespace std;
@@ -42,85 +45,22 @@ using namespace std;
 #define Ci 9
 #define null -1
 
-//Find the root of the tree of node i
-//template<typename LabelT>
+// 'tracker' is notified of every new provisional label and of every labeled pixel (see labelTracker in labelingAccess.h)
+template <typename ImgT, typename LabelsT, typename EquivT, typename TrackerT>
 inline static
-uint findRoot(const uint *P, uint i){
-	uint root = i;
-	while (P[root] < root){
-		root = P[root];
-	}
-	return root;
-}
-
-//Make all nodes in the path of node i point to root
-//template<typename LabelT>
-inline static
-void setRoot(uint *P, uint i, uint root){
-	while (P[i] < i){
-		uint j = P[i];
-		P[i] = root;
-		i = j;
-	}
-	P[i] = root;
-}
-
-//Find the root of the tree of the node i and compress the path in the process
-//template<typename LabelT>
-inline static
-uint find(uint *P, uint i){
-	uint root = findRoot(P, i);
-	setRoot(P, i, root);
-	return root;
-}
-
-//unite the two trees containing nodes i and j and return the new root
-//template<typename LabelT>
-inline static
-uint set_union(uint *P, uint i, uint j){
-	uint root = findRoot(P, i);
-	if (i != j){
-		uint rootj = findRoot(P, j);
-		if (root > rootj){
-			root = rootj;
-		}
-		setRoot(P, j, root);
-	}
-	setRoot(P, i, root);
-	return root;
-}
-
-//Flatten the Union Find tree and relabel the components
-//template<typename LabelT>
-inline static
-uint flattenL(uint *P, uint length){
-	uint k = 1;
-	for (uint i = 1; i < length; ++i){
-		if (P[i] < i){
-			P[i] = P[P[i]];
-		}
-		else{
-			P[i] = k; k = k + 1;
-		}
-	}
-	return k;
-}
-
-
-inline static
-void firstScanCTB_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &lunique) {
+void firstScanCTB_OPT(ImgT &img, LabelsT& imgLabels, EquivT &P, uint &lunique, TrackerT &tracker) {
     int w(img.cols), h(img.rows); 
 
     for (int r = 0; r < h; r += 2) {
         int prob_fol_state = null;
         int prev_state = null;
         // Get rows pointer
-        const uchar* const img_row = img.ptr<uchar>(r);
-        const uchar* const img_row_prev = (uchar *)(((char *)img_row) - img.step.p[0]);
-        const uchar* const img_row_fol = (uchar *)(((char *)img_row) + img.step.p[0]);
-        uint* const imgLabels_row = imgLabels.ptr<uint>(r);
-        uint* const imgLabels_row_prev = (uint *)(((char *)imgLabels_row) - imgLabels.step.p[0]);
-        uint* const imgLabels_row_fol = (uint *)(((char *)imgLabels_row) + imgLabels.step.p[0]);
+        const auto img_row = imageRow(img, r);
+        const auto img_row_prev = imageRow(img, r - 1);
+        const auto img_row_fol = imageRow(img, r + 1);
+        const auto imgLabels_row = labelsRow(imgLabels, r);
+        const auto imgLabels_row_prev = labelsRow(imgLabels, r - 1);
+        const auto imgLabels_row_fol = labelsRow(imgLabels, r + 1);
 
         for (int c = 0; c < w; c += 1) {
 
@@ -181,6 +121,7 @@ void firstScanCTB_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &lunique
                                 // new label
                                 imgLabels_row[c] = lunique;
 								P[lunique] = lunique;
+                                tracker.newLabel(lunique, r, c);
                                 lunique++;
                             }
                         }
@@ -197,6 +138,7 @@ void firstScanCTB_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &lunique
                         // new label for b
                         imgLabels_row_fol[c] = lunique;
 						P[lunique] = lunique;
+                        tracker.newLabel(lunique, r + 1, c);
                         lunique++;
                     }
                     else{
@@ -638,6 +580,7 @@ void firstScanCTB_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &lunique
                             // new label for a, not need to check n1
                             imgLabels_row[c] = lunique;
 							P[lunique] = lunique;
+                            tracker.newLabel(lunique, r, c);
                             lunique++;
                             prob_fol_state = Cf;
                         }
@@ -652,6 +595,7 @@ void firstScanCTB_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &lunique
                         // new label for b
                         imgLabels_row_fol[c] = lunique;
 						P[lunique] = lunique;
+                        tracker.newLabel(lunique, r + 1, c);
                         lunique++;
                         prev_state = Cg;
                     }
@@ -662,36 +606,140 @@ void firstScanCTB_OPT(const Mat1b &img, Mat1i& imgLabels, uint* P, uint &lunique
                 }
                 break;
             }//End switch
+
+            // Pixels a and b are labeled
+            tracker.labeled(imgLabels_row, r, c);
+            if (r + 1 < h)
+                tracker.labeled(imgLabels_row_fol, r + 1, c);
         }//End columns's for
     }//End rows's for
 }
 
+template <typename LabelsT, typename EquivT>
+inline static
+void secondScanCTB_OPT(LabelsT& imgLabels, EquivT &P) {
+    for (int r_i = 0; r_i < imgLabels.rows; ++r_i){
+        const auto imgLabels_row = labelsRow(imgLabels, r_i);
+        for (int c_i = 0; c_i < imgLabels.cols; ++c_i){
+            const uint l = P[imgLabels_row[c_i]];
+            imgLabels_row[c_i] = l;
+        }
+    }
+}
+
+template <typename SolverT>
+int CTB_OPT_UF(const cv::Mat1b &img, cv::Mat1i &imgLabels) {
+
+    imgLabels = cv::Mat1i(img.size(), 0); // memset is used
+	labelTracker tracker;
+	return labelBlocks<SolverT>(img.rows, img.cols,
+		[&](SolverT &P, uint &lunique) { firstScanCTB_OPT(img, imgLabels, P, lunique, tracker); },
+		[&](SolverT &P, uint, uint nLabel) {
+			// second scan
+			secondScanCTB_OPT(imgLabels, P);
+			return nLabel;
+		});
+}
+
 int CTB_OPT(const cv::Mat1b &img, cv::Mat1i &imgLabels) {
-	
-    imgLabels = cv::Mat1i(img.size(),0); // memset is used
-	//A quick and dirty upper bound for the maximimum number of labels.
-	const size_t Plength = img.rows*img.cols / 4;
+	return CTB_OPT_UF<ufSuzuki>(img, imgLabels);
+}
+
+template int CTB_OPT_UF<ufSuzuki>(const cv::Mat1b &img, cv::Mat1i &imgLabels);
+template int CTB_OPT_UF<ufHalving>(const cv::Mat1b &img, cv::Mat1i &imgLabels);
+template int CTB_OPT_UF<ufSplitting>(const cv::Mat1b &img, cv::Mat1i &imgLabels);
+template int CTB_OPT_UF<ufRank>(const cv::Mat1b &img, cv::Mat1i &imgLabels);
+template int CTB_OPT_UF<ufSize>(const cv::Mat1b &img, cv::Mat1i &imgLabels);
+template int CTB_OPT_UF<ufRem>(const cv::Mat1b &img, cv::Mat1i &imgLabels);
+template int CTB_OPT_UF<ufLists>(const cv::Mat1b &img, cv::Mat1i &imgLabels);
+
+int CTB_OPT_AREA(const cv::Mat1b &img, cv::Mat1i &imgLabels, uint min_area) {
+
+    imgLabels = cv::Mat1i(img.size(), 0); // memset is used
+	areaTracker tracker(img, blockLabelsBound(img.rows, img.cols), 1);
+	return labelBlocks<ufSuzuki>(img.rows, img.cols,
+		[&](ufSuzuki &P, uint &lunique) { firstScanCTB_OPT(img, imgLabels, P, lunique, tracker); },
+		[&](ufSuzuki &P, uint lunique, uint nLabel) {
+			nLabel = filterAreas(P, lunique, nLabel, tracker.areas, min_area);
+			// second scan
+			secondScanCTB_OPT(imgLabels, P);
+			return nLabel;
+		});
+}
+
+int CTB_OPT_AREA_ALL(const cv::Mat1b &img, cv::Mat1i &imgLabels) {
+	return CTB_OPT_AREA(img, imgLabels, 0);
+}
+
+int CTB_OPT_THR(const cv::Mat1b &grey, cv::Mat1i &imgLabels, uchar thresh, int cmp) {
+
+	const thresholdImage img(grey, thresh, cmp);
+
+	imgLabels = cv::Mat1i(img.rows, img.cols, 0); // memset is used
+	labelTracker tracker;
+	return labelBlocks<ufSuzuki>(img.rows, img.cols,
+		[&](ufSuzuki &P, uint &lunique) { firstScanCTB_OPT(img, imgLabels, P, lunique, tracker); },
+		[&](ufSuzuki &P, uint, uint nLabel) {
+			// second scan
+			secondScanCTB_OPT(imgLabels, P);
+			return nLabel;
+		});
+}
+
+int CTB_OPT_THR_BINARY(const cv::Mat1b &img, cv::Mat1i &imgLabels) {
+	return CTB_OPT_THR(img, imgLabels, 0, cv::CMP_GT);
+}
+
+int CTB_OPT_BOXES(const cv::Mat1b &img, std::vector<cv::Rect> &boxes) {
+
+	// The second scan is skipped, so the first scan keeps provisional labels only for the rows it reads
+	rollingLabels imgLabels(img.size());
+	boxTracker tracker(img, blockLabelsBound(img.rows, img.cols), 1);
+	return labelBlocks<ufSuzuki>(img.rows, img.cols,
+		[&](ufSuzuki &P, uint &lunique) { firstScanCTB_OPT(img, imgLabels, P, lunique, tracker); },
+		[&](ufSuzuki &P, uint lunique, uint nLabel) {
+			mergeBoxes(P, lunique, nLabel, tracker, boxes);
+			return nLabel;
+		});
+}
+
+int CTB_OPT_BOXES_CHECK(const cv::Mat1b &img, cv::Mat1i &imgLabels) {
+	const int nLabel = CTB_OPT(img, imgLabels);
+	vector<cv::Rect> boxes, expected;
+	labelsBoxes(imgLabels, nLabel, expected);
+	if (CTB_OPT_BOXES(img, boxes) != nLabel || boxes != expected)
+		return 0;
+	return nLabel;
+}
+
+int CTB_MEM(const cv::Mat1b &img_origin, vector<unsigned long int> &accesses) {
+
+	memMat<uchar> img(img_origin, MD_BINARY_MAT);
+	memMat<int> imgLabels(img_origin.size(), 0, MD_LABELED_MAT); // memset is used
 	//Tree of labels
-	uint *P = (uint *)fastMalloc(sizeof(uint)* Plength);
-	//Background
-	P[0] = 0;
-	uint lunique = 1;
+	memVector<uint> P(blockLabelsBound(img_origin.rows, img_origin.cols), MD_EQUIVALENCE_VEC);
 
-    firstScanCTB_OPT(img, imgLabels, P, lunique);
+	// Same code of CTB_OPT, instantiated on the counting data structures
+	labelTracker tracker;
+	const int nLabel = labelBlocks(P,
+		[&](memVector<uint> &P, uint &lunique) {
+			memoryPhase("first_scan");
+			firstScanCTB_OPT(img, imgLabels, P, lunique, tracker);
+			// Flattening follows
+			memoryPhase("flatten");
+		},
+		[&](memVector<uint> &P, uint, uint nLabel) {
+			memoryPhase("second_scan");
+			secondScanCTB_OPT(imgLabels, P);
+			return nLabel;
+		});
 
-	uint nLabel = flattenL(P, lunique);
+	// Store total accesses in the output vector 'accesses'
+	accesses = vector<unsigned long int>((int)MD_SIZE, 0);
 
-	// second scan
-    for (int r_i = 0; r_i < imgLabels.rows; ++r_i){
-        uint *imgLabels_row_start = imgLabels.ptr<uint>(r_i);
-        uint *imgLabels_row_end = imgLabels_row_start + imgLabels.cols;
-        uint *imgLabels_row = imgLabels_row_start;
-        for (int c_i = 0; imgLabels_row != imgLabels_row_end; ++imgLabels_row, ++c_i){
-            const uint l = P[*imgLabels_row];
-            *imgLabels_row = l;
-        }
-    }
+	accesses[MD_BINARY_MAT] = (unsigned long int)img.getTotalAcesses();
+	accesses[MD_LABELED_MAT] = (unsigned long int)imgLabels.getTotalAcesses();
+	accesses[MD_EQUIVALENCE_VEC] = (unsigned long int)P.getTotalAcesses();
 
-	fastFree(P);
 	return nLabel;
 }
@@ -28,9 +28,38 @@
 
 #pragma once
 #include "opencv2/opencv.hpp"
+#include "equivalenceSolverPolicies.h"
 
 // Readable version of He's algorithm
 //int CTB(const cv::Mat1b &img, cv::Mat1i &imgLabels);
 
 // Optimized version of He's algorithm
 int CTB_OPT(const cv::Mat1b &img, cv::Mat1i &imgLabels);
+
+// Optimized version of He's algorithm with the union-find strategy 'SolverT' (see equivalenceSolverPolicies.h), 
+// instantiated for all the solvers of that header
+template <typename SolverT>
+int CTB_OPT_UF(const cv::Mat1b &img, cv::Mat1i &imgLabels);
+
+// Optimized version of He's algorithm on a greyscale image, thresholded while labeling (see BBDT_OPT_THR)
+int CTB_OPT_THR(const cv::Mat1b &grey, cv::Mat1i &imgLabels, uchar thresh, int cmp = cv::CMP_GT);
+
+// Optimized version of He's algorithm which removes the components with less than 'min_area' pixels: 
+// areas are collected by the first scan, and the other components are labeled contiguously
+int CTB_OPT_AREA(const cv::Mat1b &img, cv::Mat1i &imgLabels, uint min_area);
+
+// CTB_OPT_AREA keeping every component (min_area 0), to check it with the other algorithms
+int CTB_OPT_AREA_ALL(const cv::Mat1b &img, cv::Mat1i &imgLabels);
+
+// Labels of CTB_OPT, to check CTB_OPT_BOXES with the other algorithms (see BBDT_OPT_BOXES_CHECK)
+int CTB_OPT_BOXES_CHECK(const cv::Mat1b &img, cv::Mat1i &imgLabels);
+
+// CTB_OPT_THR with the foreground of binary images (values greater than 0), to check it with the other algorithms
+int CTB_OPT_THR_BINARY(const cv::Mat1b &img, cv::Mat1i &imgLabels);
+
+// Optimized version of He's algorithm which computes only the bounding boxes of the components (boxes[0] is 
+// empty), skipping the second scan
+int CTB_OPT_BOXES(const cv::Mat1b &img, std::vector<cv::Rect> &boxes);
+
+// Version of He's algorithm which provides memory accesses details (CTB_OPT instantiated on memMat/memVector)
+int CTB_MEM(const cv::Mat1b &img, std::vector<unsigned long int> &accesses);
@@ -0,0 +1,130 @@
+// Copyright(c) 2016 - Costantino Grana, Federico Bolelli, Lorenzo Baraldi and Roberto Vezzani
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// *Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+// 
+// * Neither the name of YACCLAB nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "labelingValues.h"
+#include "equivalenceSolverSuzuki.h"
+
+using namespace cv;
+using namespace std;
+
+// Same decision tree of the binary scan with the mask
+// +--+--+--+
+// |p |q |r |
+// +--+--+--+
+// |s |x |
+// +--+--+
+// where a neighbor is connected to x if it has its value: since two pixels of the mask adjacent to each other 
+// with the value of x are already in the same tree, only q, r, p and s are checked in this order, and a union 
+// is needed only for r with p or s.
+template <typename PixelT>
+static int labelValues(const Mat_<PixelT> &img, Mat1i &imgLabels, int ignore) {
+	const int h = img.rows, w = img.cols;
+	imgLabels = Mat1i(img.size());
+
+	//Every pixel may have its own label
+	const size_t Plength = (size_t)h * w + 1;
+	//Tree of labels
+	uint *P = (uint *)fastMalloc(sizeof(uint)* Plength);
+	//Background
+	P[0] = 0;
+	uint lunique = 1;
+
+	// First scan
+	for (int r = 0; r < h; ++r) {
+		const PixelT * const img_row = img.template ptr<PixelT>(r);
+		const PixelT * const img_row_prev = r > 0 ? img.template ptr<PixelT>(r - 1) : nullptr;
+		uint * const imgLabels_row = imgLabels.ptr<uint>(r);
+		const uint * const imgLabels_row_prev = r > 0 ? imgLabels.ptr<uint>(r - 1) : nullptr;
+
+		for (int c = 0; c < w; ++c) {
+			const PixelT x = img_row[c];
+			if ((int)x == ignore) {
+				imgLabels_row[c] = 0;
+				continue;
+			}
+
+#define condition_p c > 0 && r > 0 && img_row_prev[c - 1] == x
+#define condition_q r > 0 && img_row_prev[c] == x
+#define condition_r c + 1 < w && r > 0 && img_row_prev[c + 1] == x
+#define condition_s c > 0 && img_row[c - 1] == x
+
+			if (condition_q) {
+				imgLabels_row[c] = imgLabels_row_prev[c];
+			}
+			else if (condition_r) {
+				if (condition_p)
+					imgLabels_row[c] = set_union(P, imgLabels_row_prev[c - 1], imgLabels_row_prev[c + 1]);
+				else if (condition_s)
+					imgLabels_row[c] = set_union(P, imgLabels_row[c - 1], imgLabels_row_prev[c + 1]);
+				else
+					imgLabels_row[c] = imgLabels_row_prev[c + 1];
+			}
+			else if (condition_p) {
+				imgLabels_row[c] = imgLabels_row_prev[c - 1];
+			}
+			else if (condition_s) {
+				imgLabels_row[c] = imgLabels_row[c - 1];
+			}
+			else {
+				// New label
+				P[lunique] = lunique;
+				imgLabels_row[c] = lunique++;
+			}
+
+#undef condition_p
+#undef condition_q
+#undef condition_r
+#undef condition_s
+		}
+	}
+	COUNT_EVENTS(CT_PROVISIONAL_LABELS, lunique - 1);
+
+	uint nLabel = flattenL(P, lunique);
+
+	// Second scan
+	for (int r = 0; r < h; ++r) {
+		uint * const imgLabels_row = imgLabels.ptr<uint>(r);
+		for (int c = 0; c < w; ++c)
+			imgLabels_row[c] = P[imgLabels_row[c]];
+	}
+
+	fastFree(P);
+	return nLabel;
+}
+
+int LABEL_VALUES(const Mat1b &img, Mat1i &imgLabels, int ignore) {
+	return labelValues(img, imgLabels, ignore);
+}
+
+int LABEL_VALUES(const Mat1w &img, Mat1i &imgLabels, int ignore) {
+	return labelValues(img, imgLabels, ignore);
+}
+
+int LABEL_VALUES_BINARY(const Mat1b &img, Mat1i &imgLabels) {
+	return LABEL_VALUES(img, imgLabels, 0);
+}
@@ -21,26 +21,25 @@
 // Specially thank for the help of Prof. Grana who provide his source code of the BBDT algorithm.
 
 #include "labelingWYChang2015.h"
+#include "labelingCounters.h"
 
 #include <stdint.h>
+#include "labelingAccess.h"
 
 using namespace cv;
 using namespace std;
 
-int CCIT_OPT(const Mat1b& img, Mat1i& imgOut) {
+// First scan of Chang's algorithm: 'aRTable', 'aNext' and 'aTail' must have room for one label for every 2x2 block, 
+// plus background, and 'imgOut' must be initialized with zeros. Return the first unused provisional label.
+template <typename ImgT, typename LabelsT, typename TableT>
+inline static
+int firstScanCCIT_OPT(ImgT& img, LabelsT& imgOut, TableT& aRTable, TableT& aNext, TableT& aTail) {
 
     unsigned char byF = 1;
 
-	// add image initialization with memset (in the original code it was made out of the labeling function but it must
-	// be considered in the total amount time requested by the algorithm, like in all the other ones is done)
-	imgOut = Mat1i(img.size(),0); 
-
     int w = imgOut.cols, h = imgOut.rows;
 
     int m = 1;
-    int *aRTable = new int[w*h / 4];
-    int *aNext = new int[w*h / 4];
-    int *aTail = new int[w*h / 4];
 
     int lx, u, v, k;
 
@@ -67,15 +66,15 @@ int CCIT_OPT(const Mat1b& img, Mat1i& imgOut) {
     #define load_Rv v = aRTable[imgOut_row_prev_prev[x+2]]
     #define load_Rk k = aRTable[imgOut_row_prev_prev[x+2]]
     #define newlabelprocess lx = newlabel; 	aRTable[m] = m;  aNext[m] = -1;  aTail[m] = m;	m = m + 1;
-    #define reslove2(u, v); 		if (u<v) { int i = v; 	while (i>-1) {	aRTable[i] = u;	i = aNext[i];	}	aNext[aTail[u]] = v; aTail[u] = aTail[v]; 	}else if (u>v) {	int i = u; 	while (i>-1) { aRTable[i] = v; 	i = aNext[i]; }	aNext[aTail[v]] = u; aTail[v] = aTail[u]; };
-    #define reslove3(u, v, k); 		if (u<v) { int i = v; 	while (i>-1) { 	aRTable[i] = u; i = aNext[i]; 	} 	aNext[aTail[u]] = v; aTail[u] = aTail[v];  k = aRTable[k]; if (u<k) { int i = k; 	while (i>-1) { 	aRTable[i] = u; i = aNext[i]; } aNext[aTail[u]] = k;  aTail[u] = aTail[k]; 	} else if (u>k) { int i = u;   while (i>-1) { aRTable[i] = k; i = aNext[i]; } aNext[aTail[k]] = u; 	aTail[k] = aTail[u]; } 	} else if (u>v) { int i = u; while (i>-1) { aRTable[i] = v;    i = aNext[i]; 	} 	aNext[aTail[v]] = u;  aTail[v] = aTail[u];	k = aRTable[k];	if (v<k) { int i = k; while (i>-1) { aRTable[i] = v;  i = aNext[i];	}   	   aNext[aTail[v]] = k; aTail[v] = aTail[k]; } else if (v>k) { int i = v;	while (i>-1) {	aRTable[i] = k; 	i = aNext[i]; } aNext[aTail[k]] = v; aTail[k] = aTail[v]; } }else { k = aRTable[k]; if (u<k) {	int i = k; while (i>-1) { aRTable[i] = u; i = aNext[i];	} aNext[aTail[u]] = k;	aTail[u] = aTail[k]; }else if (u>k) { int i = u;	while (i>-1) {	aRTable[i] = k;	i = aNext[i]; } aNext[aTail[k]] = u; aTail[k] = aTail[u]; }; };
+    #define reslove2(u, v); 		COUNT_EVENT(CT_UNIONS); if (u<v) { int i = v; 	while (i>-1) { COUNT_EVENT(CT_RELINK_STEPS);	aRTable[i] = u;	i = aNext[i];	}	aNext[aTail[u]] = v; aTail[u] = aTail[v]; 	}else if (u>v) {	int i = u; 	while (i>-1) { COUNT_EVENT(CT_RELINK_STEPS); aRTable[i] = v; 	i = aNext[i]; }	aNext[aTail[v]] = u; aTail[v] = aTail[u]; };
+    #define reslove3(u, v, k); 		COUNT_EVENTS(CT_UNIONS, 2); if (u<v) { int i = v; 	while (i>-1) { COUNT_EVENT(CT_RELINK_STEPS); 	aRTable[i] = u; i = aNext[i]; 	} 	aNext[aTail[u]] = v; aTail[u] = aTail[v];  k = aRTable[k]; if (u<k) { int i = k; 	while (i>-1) { COUNT_EVENT(CT_RELINK_STEPS); 	aRTable[i] = u; i = aNext[i]; } aNext[aTail[u]] = k;  aTail[u] = aTail[k]; 	} else if (u>k) { int i = u;   while (i>-1) { COUNT_EVENT(CT_RELINK_STEPS); aRTable[i] = k; i = aNext[i]; } aNext[aTail[k]] = u; 	aTail[k] = aTail[u]; } 	} else if (u>v) { int i = u; while (i>-1) { COUNT_EVENT(CT_RELINK_STEPS); aRTable[i] = v;    i = aNext[i]; 	} 	aNext[aTail[v]] = u;  aTail[v] = aTail[u];	k = aRTable[k];	if (v<k) { int i = k; while (i>-1) { COUNT_EVENT(CT_RELINK_STEPS); aRTable[i] = v;  i = aNext[i];	}   	   aNext[aTail[v]] = k; aTail[v] = aTail[k]; } else if (v>k) { int i = v;	while (i>-1) { COUNT_EVENT(CT_RELINK_STEPS);	aRTable[i] = k; 	i = aNext[i]; } aNext[aTail[k]] = v; aTail[k] = aTail[v]; } }else { k = aRTable[k]; if (u<k) {	int i = k; while (i>-1) { COUNT_EVENT(CT_RELINK_STEPS); aRTable[i] = u; i = aNext[i];	} aNext[aTail[u]] = k;	aTail[u] = aTail[k]; }else if (u>k) { int i = u;	while (i>-1) { COUNT_EVENT(CT_RELINK_STEPS);	aRTable[i] = k;	i = aNext[i]; } aNext[aTail[k]] = u; aTail[k] = aTail[u]; }; };
 
     bool nextprocedure2;
 
     int y = 0; // extract from the first for
-    const uchar* const img_row = img.ptr<uchar>(y);
-    const uchar* const img_row_fol = (uchar *)(((char *)img_row) + img.step.p[0]);
-    uint* const imgOut_row = imgOut.ptr<uint>(y);
+    const auto img_row = imageRow(img, y);
+    const auto img_row_fol = imageRow(img, y + 1);
+    const auto imgOut_row = labelsRow(imgOut, y);
     //prcess first two rows
     // cout << "." << endl;
     for (int x = 0; x<w; x += 2) {
@@ -146,11 +145,11 @@ int CCIT_OPT(const Mat1b& img, Mat1i& imgOut) {
 
     // cout << "." << endl;
     for (int y = 2; y<h; y += 2) {
-        const uchar* const img_row = img.ptr<uchar>(y);
-        const uchar* const img_row_prev = (uchar *)(((char *)img_row) - img.step.p[0]);
-        const uchar* const img_row_fol = (uchar *)(((char *)img_row) + img.step.p[0]);
-        uint* const imgOut_row = imgOut.ptr<uint>(y);
-        uint* const imgOut_row_prev_prev = (uint *)(((char *)imgOut_row) - imgOut.step.p[0] - imgOut.step.p[0]);
+        const auto img_row = imageRow(img, y);
+        const auto img_row_prev = imageRow(img, y - 1);
+        const auto img_row_fol = imageRow(img, y + 1);
+        const auto imgOut_row = labelsRow(imgOut, y);
+        const auto imgOut_row_prev_prev = labelsRow(imgOut, y - 2);
         for (int x = 0; x<w; x += 2) {
             if (condition_b1){
                 if (condition_b2){
@@ -413,8 +412,13 @@ int CCIT_OPT(const Mat1b& img, Mat1i& imgOut) {
             }
         }
     }
-    // cout << "." << endl;
-    //Renew label number
+    return m;
+}
+
+// Renew label number: 'aRTable' maps provisional labels to final ones. Return the number of labels.
+template <typename TableT>
+inline static
+int flattenCCIT_OPT(TableT& aRTable, int m) {
     int iCurLabel = 0;
     for (int i = 1; i<m; i++) {
         if (aRTable[i] == i) {
@@ -424,13 +428,22 @@ int CCIT_OPT(const Mat1b& img, Mat1i& imgOut) {
         else
             aRTable[i] = aRTable[aRTable[i]];
     }
-    // cout << "." << endl;
-    // SECOND SCAN 
+    return ++iCurLabel;
+}
+
+template <typename ImgT, typename LabelsT, typename TableT>
+inline static
+void secondScanCCIT_OPT(ImgT& img, LabelsT& imgOut, TableT& aRTable) {
+
+    unsigned char byF = 1;
+
+    int w = imgOut.cols, h = imgOut.rows;
+
     for (int y = 0; y<h; y += 2) {
-        const uchar* const img_row = img.ptr<uchar>(y);
-        const uchar* const img_row_fol = (uchar *)(((char *)img_row) + img.step.p[0]);
-        uint* const imgOut_row = imgOut.ptr<uint>(y);
-        uint* const imgOut_row_fol = (uint *)(((char *)imgOut_row) + imgOut.step.p[0]);
+        const auto img_row = imageRow(img, y);
+        const auto img_row_fol = imageRow(img, y + 1);
+        const auto imgOut_row = labelsRow(imgOut, y);
+        const auto imgOut_row_fol = labelsRow(imgOut, y + 1);
         for (int x = 0; x<w; x += 2) {
             int iLabel = imgOut_row[x];
             if (iLabel>0) {
@@ -478,12 +491,61 @@ int CCIT_OPT(const Mat1b& img, Mat1i& imgOut) {
             }
         }
     }
-    //cout << "." << endl;
+}
+
+int CCIT_OPT(const Mat1b& img, Mat1i& imgOut) {
+
+	// add image initialization with memset (in the original code it was made out of the labeling function but it must
+	// be considered in the total amount time requested by the algorithm, like in all the other ones is done)
+	imgOut = Mat1i(img.size(),0); 
+
+    // A quick and dirty upper bound for the maximimum number of labels (one for every 2x2 block, plus background)
+    const size_t Plength = ((size_t)img.rows + 1) / 2 * (((size_t)img.cols + 1) / 2) + 1;
+    int *aRTable = new int[Plength];
+    int *aNext = new int[Plength];
+    int *aTail = new int[Plength];
+
+    int m = firstScanCCIT_OPT(img, imgOut, aRTable, aNext, aTail);
+    COUNT_EVENTS(CT_PROVISIONAL_LABELS, m - 1);
+
+    int nLabel = flattenCCIT_OPT(aRTable, m);
+
+    // SECOND SCAN 
+    secondScanCCIT_OPT(img, imgOut, aRTable);
 
-    // output the number of labels
-    //*numLabels = iCurLabel;
     delete[] aRTable; // add []
     delete[] aNext; // add []
     delete[] aTail; //add []
-    return ++iCurLabel;
-}
\ No newline at end of file
+    return nLabel;
+}
+
+int CCIT_MEM(const Mat1b& img_origin, vector<unsigned long int> &accesses) {
+
+    const size_t Plength = ((size_t)img_origin.rows + 1) / 2 * (((size_t)img_origin.cols + 1) / 2) + 1;
+
+    memMat<uchar> img(img_origin, MD_BINARY_MAT);
+    memMat<int> imgOut(img_origin.size(), 0, MD_LABELED_MAT); // memset is used
+    // The three tables together implement the equivalences
+    memVector<int> aRTable(Plength, MD_EQUIVALENCE_VEC);
+    memVector<int> aNext(Plength, MD_EQUIVALENCE_VEC);
+    memVector<int> aTail(Plength, MD_EQUIVALENCE_VEC);
+
+    // Same code of CCIT_OPT, instantiated on the counting data structures
+    memoryPhase("first_scan");
+    int m = firstScanCCIT_OPT(img, imgOut, aRTable, aNext, aTail);
+
+    memoryPhase("flatten");
+    int nLabel = flattenCCIT_OPT(aRTable, m);
+
+    memoryPhase("second_scan");
+    secondScanCCIT_OPT(img, imgOut, aRTable);
+
+    // Store total accesses in the output vector 'accesses'
+    accesses = vector<unsigned long int>((int)MD_SIZE, 0);
+
+    accesses[MD_BINARY_MAT] = (unsigned long int)img.getTotalAcesses();
+    accesses[MD_LABELED_MAT] = (unsigned long int)imgOut.getTotalAcesses();
+    accesses[MD_EQUIVALENCE_VEC] = (unsigned long int)(aRTable.getTotalAcesses() + aNext.getTotalAcesses() + aTail.getTotalAcesses());
+
+    return nLabel;
+}
@@ -32,3 +32,7 @@
 
 // Optimized version of Wan-Yu Chang's algorithm ( block based ) 
 int CCIT_OPT(const cv::Mat1b &img, cv::Mat1i &imgLabels);
+
+// Version of Wan-Yu Chang's algorithm which provides memory accesses details (CCIT_OPT instantiated on memMat/memVector, 
+// aRTable, aNext and aTail are counted as equivalence vectors)
+int CCIT_MEM(const cv::Mat1b &img, std::vector<unsigned long int> &accesses);
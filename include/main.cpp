@@ -34,6 +34,7 @@
 #include <iostream>
 #include <iomanip>
 #include <cstdint>
+#include <cstring>
 #include <deque>          
 #include <list>           
 #include <queue>
@@ -41,13 +42,28 @@
 #include <array> 
 #include <algorithm>
 #include <functional>
+#include <atomic>
+#include <mutex>
 
 #include "performanceEvaluator.h"
 #include "configurationReader.h"
 #include "labelingAlgorithms.h"
+#include "labelingHe2008.h"
+#include "labelingHe2014.h"
+#include "labelingWYChang2015.h"
+#include "labeling3D.h"
+#include "labelingValues.h"
+#include "maxTree.h"
 #include "foldersManager.h"
 #include "progressBar.h"
 #include "memoryTester.h"
+#include "labelingCounters.h"
+#include "imageGenerator.h"
+#include "resultsExporter.h"
+#include "benchmarkHistory.h"
+#include "workerPool.h"
+#include "goldenLabels.h"
+#include "asyncWriter.h"
 
 using namespace cv;
 using namespace std;
@@ -55,6 +71,11 @@ using namespace std;
 #include <sys/types.h>
 #include <sys/stat.h>
 
+#if !defined(YACCLAB_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define COLORS_SSE2
+#include <emmintrin.h>
+#endif
+
 const char kPathSeparator =
 #ifdef _WIN32
                             '\\';
@@ -71,12 +92,84 @@ const char kPathSeparator =
 #endif
 
 // Create a bunch of pseudo random colors from labels indexes and create a
-// color representation for the labels
+// color representation for the labels. Labels are numbered in row major order first (as normalizeLabels
+// does), so the same components get the same colors whatever algorithm labeled them: a lookup table from
+// labels to colors (packed in 32 bits) is filled at the first appearance of every label and then used for 
+// every pixel. With SSE2 (define YACCLAB_NO_SIMD to disable it) four pixels are colored at a time: runs of 
+// the last label are detected with a single comparison, the colors of the others are gathered from the table, 
+// and the four colors are packed into 12 bytes in registers.
 void colorLabels(const Mat1i& imgLabels, Mat3b& imgOut) {
+
+	uint maxLabel = 0;
+	for (int r = 0; r < imgLabels.rows; ++r) {
+		const uint * const imgLabels_row = imgLabels.ptr<uint>(r);
+		int c = 0;
+#ifdef COLORS_SSE2
+		// Labels are not negative, so the signed comparison gives the maximum
+		__m128i max4 = _mm_setzero_si128();
+		for (; c + 4 <= imgLabels.cols; c += 4) {
+			const __m128i labels4 = _mm_loadu_si128((const __m128i*)(imgLabels_row + c));
+			const __m128i greater = _mm_cmpgt_epi32(labels4, max4);
+			max4 = _mm_or_si128(_mm_and_si128(greater, labels4), _mm_andnot_si128(greater, max4));
+		}
+		uint max4_lanes[4];
+		_mm_storeu_si128((__m128i*)max4_lanes, max4);
+		for (int i = 0; i < 4; ++i)
+			maxLabel = max(maxLabel, max4_lanes[i]);
+#endif
+		for (; c < imgLabels.cols; ++c)
+			maxLabel = max(maxLabel, imgLabels_row[c]);
+	}
+
+	// Colors as 0x00RRGGBB, so that the bytes in memory are in BGR order (background is black)
+	vector<uint32_t> colors((size_t)maxLabel + 1, 0);
+	vector<char> seen((size_t)maxLabel + 1, 0);
+	seen[0] = 1;
+	int iMaxNewLabel = 0;
+	auto color = [&](uint iCurLabel) {
+		if (!seen[iCurLabel]) {
+			seen[iCurLabel] = 1;
+			++iMaxNewLabel;
+			colors[iCurLabel] = (uint32_t)(iMaxNewLabel * 131 % 255) | (uint32_t)(iMaxNewLabel * 241 % 255) << 8 | (uint32_t)(iMaxNewLabel * 251 % 255) << 16;
+		}
+		return colors[iCurLabel];
+	};
+
 	imgOut = Mat3b(imgLabels.size());
-	for (int r = 0; r<imgLabels.rows; ++r) {
-		for (int c = 0; c<imgLabels.cols; ++c) {
-			imgOut(r, c) = Vec3b(imgLabels(r, c) * 131 % 255, imgLabels(r, c) * 241 % 255, imgLabels(r, c) * 251 % 255);
+	for (int r = 0; r < imgLabels.rows; ++r) {
+		const uint * const imgLabels_row = imgLabels.ptr<uint>(r);
+		uchar * const imgOut_row = imgOut.ptr<uchar>(r);
+		int c = 0;
+#ifdef COLORS_SSE2
+		const __m128i low_pixel = _mm_set_epi32(0, 0x00FFFFFF, 0, 0x00FFFFFF), high_pixel = _mm_set_epi32(0x0000FFFF, (int)0xFF000000, 0x0000FFFF, (int)0xFF000000);
+		const __m128i low_lane = _mm_set_epi32(0, 0, -1, -1);
+		uint lastLabel = 0;
+		__m128i lastColor4 = _mm_setzero_si128();
+		for (; c + 4 <= imgLabels.cols; c += 4) {
+			const __m128i labels4 = _mm_loadu_si128((const __m128i*)(imgLabels_row + c));
+			__m128i colors4;
+			if (_mm_movemask_epi8(_mm_cmpeq_epi32(labels4, _mm_set1_epi32((int)lastLabel))) == 0xFFFF)
+				colors4 = lastColor4;
+			else {
+				const uint32_t color0 = color(imgLabels_row[c]), color1 = color(imgLabels_row[c + 1]), color2 = color(imgLabels_row[c + 2]);
+				const uint32_t color3 = color(lastLabel = imgLabels_row[c + 3]);
+				colors4 = _mm_set_epi32((int)color3, (int)color2, (int)color1, (int)color0);
+				lastColor4 = _mm_set1_epi32((int)color3);
+			}
+			// Every 64 bit lane holds two pixels of 4 bytes: the second one is moved next to the first one (6 bytes), 
+			// then the second lane is moved next to the first one (12 bytes)
+			const __m128i packed = _mm_or_si128(_mm_and_si128(colors4, low_pixel), _mm_and_si128(_mm_srli_epi64(colors4, 8), high_pixel));
+			const __m128i bgr4 = _mm_or_si128(_mm_and_si128(packed, low_lane), _mm_srli_si128(_mm_andnot_si128(low_lane, packed), 2));
+			_mm_storel_epi64((__m128i*)(imgOut_row + 3 * c), bgr4);
+			const int last4 = _mm_cvtsi128_si32(_mm_srli_si128(bgr4, 8));
+			memcpy(imgOut_row + 3 * c + 8, &last4, 4);
+		}
+#endif
+		for (; c < imgLabels.cols; ++c) {
+			const uint32_t bgr = color(imgLabels_row[c]);
+			imgOut_row[3 * c] = (uchar)bgr;
+			imgOut_row[3 * c + 1] = (uchar)(bgr >> 8);
+			imgOut_row[3 * c + 2] = (uchar)(bgr >> 16);
 		}
 	}
 }
@@ -145,81 +238,143 @@ void deleteCarriageReturn(string &s){
 }
 
 
-// To check the correctness of algorithms on datasets specified
-void checkAlgorithms(vector<pair<CCLPointer, string>>& CCLAlgorithms, const vector<string>& datasets, const string& input_path, const string& input_txt){
+// To check the correctness of algorithms on datasets specified. SAUF_OPT is the reference, but its labeling of every image is 
+// computed only once: the hash of the normalized labels and the number of labels are stored in "<output>/<dataset>/golden.tsv" 
+// (see goldenLabels.h) and candidates are checked against them. Only if a candidate does not match, the reference is computed 
+// again and compared with the candidate by equivalentLabels (stored results may be stale). Images are checked in parallel by 'threads' 
+// workers (0 for one for every hardware thread).
+void checkAlgorithms(vector<pair<CCLPointer, string>>& CCLAlgorithms, const vector<string>& datasets, const string& input_path, const string& input_txt, const string& output_path, unsigned threads){
 
     vector<bool> stats(CCLAlgorithms.size(), true); // true if the i-th algorithm is correct, false otherwise
     vector<string> firstFail(CCLAlgorithms.size()); // name of the file on which algorithm fails the first time
-    bool stop = false; // true if all algorithms are incorrect
+    vector<Point> firstFailPixel(CCLAlgorithms.size()); // first wrong pixel on that file
     bool checkPerform = false; // true if almost one check was execute 
 
     for (uint i = 0; i < datasets.size(); ++i){
         // For every dataset in check list
+        if (std::find(stats.begin(), stats.end(), true) == stats.end())
+            break; // All algorithms are incorrect
 
         cout << "Test on " << datasets[i] << " starts: " << endl; 
 
-        string is_path = input_path + kPathSeparator + datasets[i] + kPathSeparator + input_txt;
+        string is_path = input_path + kPathSeparator + datasets[i] + kPathSeparator + input_txt,
+               golden_folder = output_path + kPathSeparator + datasets[i],
+               golden_path = golden_folder + kPathSeparator + "golden.tsv";
         
-        ifstream supp(is_path);
-        if (!supp.is_open()){
-            cout<< "Unable to open " + is_path;
-            continue; 
-        }
-        // Count number of lines to display progress bar
-        int fileNumber = (int)std::count(std::istreambuf_iterator<char>(supp), std::istreambuf_iterator<char>(), '\n');
-        supp.close();
-        //Reopen file
         ifstream is(is_path);
         if (!is.is_open()){
-            cout << "Unable to open " + is_path<< endl;
+            cout << "Unable to open " + is_path << endl;
             continue;
         }
-        
-        // Count number of lines to display progress bar
-        uint currentNumber = 0;
-
+        vector<string> filesNames;
         string filename;
-        while (getline(is, filename) && !stop){
+        while (getline(is, filename)){
+            deleteCarriageReturn(filename);
+            filesNames.push_back(filename);
+        }
+        is.close();
+        const size_t fileNumber = filesNames.size();
 
-			deleteCarriageReturn(filename); 
+        map<string, goldenLabels> golden;
+        loadGoldenLabels(golden_path, golden);
 
-            // Display "progress bar"
-            if (currentNumber * 100 / fileNumber != (currentNumber - 1) * 100 / fileNumber){
-                cout << currentNumber << "/" << fileNumber << "         \r";
-                fflush(stdout); 
-            }
-            currentNumber++;
+        // Results of the images are stored by index, the golden map is only read by workers
+        vector<goldenLabels> newGolden(fileNumber);
+        vector<char> updatedGolden(fileNumber, 0);
+        vector<size_t> failIndex(CCLAlgorithms.size(), fileNumber); // First image on which the algorithm fails
+        vector<Point> failPixel(CCLAlgorithms.size());
+        atomic<uint> currentNumber(0);
+        mutex check_mutex;
 
-            Mat1b binaryImg;
-            Mat1i labeledImgCorrect, labeledImgToControl;
-            unsigned nLabelsCorrect, nLabelsToControl;
+        parallelFor(fileNumber, threads, [&](size_t file, unsigned){
 
-            if (!getBinaryImage(input_path + kPathSeparator + datasets[i] + kPathSeparator + filename, binaryImg)){
-                cout << "Unable to check on '" + filename + "', file does not exist" << endl;
-                continue;
+            Mat1b binaryImg;
+            if (!getBinaryImage(input_path + kPathSeparator + datasets[i] + kPathSeparator + filesNames[file], binaryImg)){
+                lock_guard<mutex> lock(check_mutex);
+                cout << "Unable to check on '" + filesNames[file] + "', file does not exist" << endl;
+                return;
             }
 
 			// SAUF_OPTOpenCVеĿԴ㷨BBDTҲOpenCVеĿԴ㷨ڴΪ׼οж㷨Ƿȷ
 			// ͨǷ׼SAUF_OPTǷһȷҪģβٶȺЧʣڴ
-            nLabelsCorrect = SAUF_OPT(binaryImg, labeledImgCorrect); // SAUF is the reference (the labels are already normalized)
+            Mat1i labeledImgCorrect, labeledImgToControl;
+            unsigned nLabelsCorrect = 0, nLabelsToControl;
+            auto computeReference = [&](){
+                if (labeledImgCorrect.empty()){
+                    nLabelsCorrect = SAUF_OPT(binaryImg, labeledImgCorrect); // SAUF is the reference
+                    newGolden[file] = { binaryImageHash(binaryImg), labelsHash(labeledImgCorrect), nLabelsCorrect };
+                }
+            };
+
+            const uint64_t image_hash = binaryImageHash(binaryImg);
+            auto stored = golden.find(filesNames[file]);
+            goldenLabels reference;
+            if (stored != golden.end() && stored->second.image_hash == image_hash)
+                reference = stored->second;
+            else{
+                computeReference();
+                reference = newGolden[file];
+                updatedGolden[file] = 1;
+            }
+
             uint j = 0; 
             for (vector<pair<CCLPointer, string>>::iterator it = CCLAlgorithms.begin(); it != CCLAlgorithms.end(); ++it, ++j){
                 // For all the Algorithms in the array
-                checkPerform = true; 
-                if (stats[j]){
-                    nLabelsToControl = (*it).first(binaryImg, labeledImgToControl);
-                    normalizeLabels(labeledImgToControl);
-                    if (nLabelsCorrect != nLabelsToControl || !compareMat(labeledImgCorrect, labeledImgToControl)){
-                        stats[j] = false;
-                        firstFail[j] = input_path + kPathSeparator + datasets[i] + kPathSeparator + filename; 
-                        if (adjacent_find(stats.begin(), stats.end(), not_equal_to<int>()) == stats.end()){
-                            stop = true; 
-                            break;
-                        }
+                if (!stats[j])
+                    continue;
+                {
+                    lock_guard<mutex> lock(check_mutex);
+                    if (failIndex[j] < file)
+                        continue; // Already failed on a previous image
+                }
+                nLabelsToControl = (*it).first(binaryImg, labeledImgToControl);
+                if (nLabelsToControl == reference.n_labels && labelsHash(labeledImgToControl) == reference.labels_hash)
+                    continue;
+
+                // Full comparison with the reference
+                computeReference();
+                Point diff;
+                if (!equivalentLabels(labeledImgCorrect, nLabelsCorrect, labeledImgToControl, nLabelsToControl, diff) || nLabelsCorrect != nLabelsToControl){
+                    lock_guard<mutex> lock(check_mutex);
+                    if (file < failIndex[j]){
+                        failIndex[j] = file;
+                        failPixel[j] = diff;
                     }
                 }
             }
-        }// END WHILE (LIST OF IMAGES)
+
+            // Stored results may be stale
+            if (!labeledImgCorrect.empty() && (newGolden[file].labels_hash != reference.labels_hash || newGolden[file].n_labels != reference.n_labels))
+                updatedGolden[file] = 1;
+
+            // Display "progress bar"
+            lock_guard<mutex> lock(check_mutex);
+            uint done = ++currentNumber;
+            if (done * 100 / fileNumber != (done - 1) * 100 / fileNumber){
+                cout << done << "/" << fileNumber << "         \r";
+                fflush(stdout);
+            }
+        });
+
+        for (size_t j = 0; j < CCLAlgorithms.size(); ++j){
+            checkPerform = checkPerform || (stats[j] && fileNumber > 0);
+            if (stats[j] && failIndex[j] < fileNumber){
+                stats[j] = false;
+                firstFail[j] = input_path + kPathSeparator + datasets[i] + kPathSeparator + filesNames[failIndex[j]];
+                firstFailPixel[j] = failPixel[j];
+            }
+        }
+
+        bool updated = false;
+        for (size_t file = 0; file < fileNumber; ++file){
+            if (updatedGolden[file]){
+                golden[filesNames[file]] = newGolden[file];
+                updated = true;
+            }
+        }
+        if (updated && !(makeDir(golden_folder) && saveGoldenLabels(golden_path, golden)))
+            cout << "Unable to open/create " + golden_path << endl;
+
         cout << currentNumber << "/" << fileNumber << "\n" << "Test on " << datasets[i] << " ends " << endl;
         fflush(stdout);
     }// END FOR (LIST OF DATASETS)
@@ -230,7 +385,8 @@ void checkAlgorithms(vector<pair<CCLPointer, string>>& CCLAlgorithms, const vect
             if (stats[j])
                 cout << "\"" << (*it).second << "\" is correct!" << endl;
             else
-                cout << "\"" << (*it).second << "\" is not correct, it first fails on " << firstFail[j] << endl;
+                cout << "\"" << (*it).second << "\" is not correct, it first fails on " << firstFail[j]
+                     << (firstFailPixel[j].x >= 0 ? " at row " + to_string(firstFailPixel[j].y) + ", column " + to_string(firstFailPixel[j].x) : " (wrong number of labels)") << endl;
         }
     }
     else{
@@ -238,6 +394,114 @@ void checkAlgorithms(vector<pair<CCLPointer, string>>& CCLAlgorithms, const vect
     }
 }
 
+// Reference labeling of volumes for check3DAlgorithms: breadth first visit of the foreground voxels, with 
+// 26-connectivity or 6-connectivity. Labels are consecutive, starting from 1, and the number of labels + 1 
+// is returned, as the labeling algorithms.
+static int visitVolume(const vector<Mat1b>& volume, vector<Mat1i>& volLabels, bool connectivity26){
+    const int d = (int)volume.size(), h = d ? volume[0].rows : 0, w = d ? volume[0].cols : 0;
+    volLabels.assign(d, Mat1i());
+    for (int z = 0; z < d; ++z)
+        volLabels[z] = Mat1i(h, w, 0);
+
+    int nLabel = 1;
+    queue<array<int, 3>> visit;
+    for (int z = 0; z < d; ++z){
+        for (int r = 0; r < h; ++r){
+            for (int c = 0; c < w; ++c){
+                if (volume[z](r, c) == 0 || volLabels[z](r, c) != 0)
+                    continue;
+                volLabels[z](r, c) = nLabel;
+                visit.push({ { z, r, c } });
+                while (!visit.empty()){
+                    const array<int, 3> v = visit.front();
+                    visit.pop();
+                    for (int dz = -1; dz <= 1; ++dz){
+                        for (int dr = -1; dr <= 1; ++dr){
+                            for (int dc = -1; dc <= 1; ++dc){
+                                if (!connectivity26 && abs(dz) + abs(dr) + abs(dc) != 1)
+                                    continue;
+                                const int nz = v[0] + dz, nr = v[1] + dr, nc = v[2] + dc;
+                                if (nz < 0 || nz >= d || nr < 0 || nr >= h || nc < 0 || nc >= w)
+                                    continue;
+                                if (volume[nz](nr, nc) != 0 && volLabels[nz](nr, nc) == 0){
+                                    volLabels[nz](nr, nc) = nLabel;
+                                    visit.push({ { nz, nr, nc } });
+                                }
+                            }
+                        }
+                    }
+                }
+                ++nLabel;
+            }
+        }
+    }
+    return nLabel;
+}
+
+// Volume labels are equivalent if they have the same number of labels and a one to one mapping between them
+static bool equivalentVolumes(const vector<Mat1i>& a, int a_labels, const vector<Mat1i>& b, int b_labels){
+    if (a_labels != b_labels || a.size() != b.size())
+        return false;
+    vector<int> a_to_b(a_labels, -1), b_to_a(b_labels, -1);
+    a_to_b[0] = b_to_a[0] = 0;
+    for (size_t z = 0; z < a.size(); ++z){
+        for (int r = 0; r < a[z].rows; ++r){
+            for (int c = 0; c < a[z].cols; ++c){
+                const int la = a[z](r, c), lb = b[z](r, c);
+                if (la < 0 || la >= a_labels || lb < 0 || lb >= b_labels)
+                    return false;
+                if (a_to_b[la] < 0 && b_to_a[lb] < 0){
+                    a_to_b[la] = lb;
+                    b_to_a[lb] = la;
+                }
+                else if (a_to_b[la] != lb || b_to_a[lb] != la)
+                    return false;
+            }
+        }
+    }
+    return true;
+}
+
+// To check the correctness of the algorithms on volumes (BBDT_3D with 26-connectivity and VOXEL_3D_6 with 6-connectivity) 
+// on random volumes of many sizes (odd and even, down to a single voxel) and densities, against a breadth first visit 
+// of the voxels
+void check3DAlgorithms(){
+    typedef int(*volumePointer)(const vector<Mat1b>&, vector<Mat1i>&);
+    const vector<pair<pair<volumePointer, bool>, string>> algorithms = {
+        { { BBDT_3D, true }, "BBDT_3D" },
+        { { VOXEL_3D_6, false }, "VOXEL_3D_6" },
+    };
+
+    RNG rng(0x3D);
+    for (const auto& algorithm : algorithms){
+        string fail;
+        for (int d : { 1, 2, 3, 6, 9 }){
+            for (int h : { 1, 2, 5, 8 }){
+                for (int w : { 1, 3, 4, 11 }){
+                    for (double density : { 0.2, 0.4, 0.6, 0.8 }){
+                        vector<Mat1b> volume(d);
+                        for (Mat1b& slice : volume){
+                            slice = Mat1b(h, w);
+                            for (int r = 0; r < h; ++r)
+                                for (int c = 0; c < w; ++c)
+                                    slice(r, c) = rng.uniform(0., 1.) < density ? 1 : 0;
+                        }
+                        vector<Mat1i> labels, reference;
+                        const int nLabels = algorithm.first.first(volume, labels);
+                        const int nReference = visitVolume(volume, reference, algorithm.first.second);
+                        if (fail.empty() && !equivalentVolumes(labels, nLabels, reference, nReference))
+                            fail = to_string(w) + "x" + to_string(h) + "x" + to_string(d) + " volumes with density " + to_string(density);
+                    }
+                }
+            }
+        }
+        if (fail.empty())
+            cout << "\"" << algorithm.second << "\" is correct!" << endl;
+        else
+            cout << "\"" << algorithm.second << "\" is not correct, it first fails on " << fail << endl;
+    }
+}
+
 // This function take a char as input and return the corresponding int value (not ASCII one)
 unsigned int ctoi(const char &c){
 	return ((int)c - 48);
@@ -282,7 +546,17 @@ void saveBroadOutputResults(const Mat1d& results, const string& oFileName, vecto
     }
 }
 
-string averages_test(vector<pair<CCLPointer, string>>& CCLAlgorithms, Mat1d& all_res, const unsigned int& alg_pos, const string& input_path, const string& input_folder, const string& input_txt, const string& gnuplot_scipt_extension, string& output_path, string& colors_folder, const bool& saveMiddleResults, const uint& nTest, const string& middleFolder, const bool& write_n_labels = true, const bool& output_colors = true){
+// Save middle results in background (see saveBroadOutputResults), on copies of the current results
+void saveMiddleResultsAsync(asyncWriter& writer, const Mat1d& results, const string& oFileName, const vector<pair<CCLPointer, string>>& CCLAlgorithms, const bool write_n_labels, const Mat1i& labels, const vector<pair<string, bool>>& filesNames){
+    Mat1d results_copy = results.clone();
+    Mat1i labels_copy = labels.clone();
+    vector<pair<CCLPointer, string>> algorithms = CCLAlgorithms;
+    writer.push([=]() mutable {
+        saveBroadOutputResults(results_copy, oFileName, algorithms, write_n_labels, labels_copy, filesNames);
+    });
+}
+
+string averages_test(vector<pair<CCLPointer, string>>& CCLAlgorithms, Mat1d& all_res, const unsigned int& alg_pos, const string& input_path, const string& input_folder, const string& input_txt, const string& gnuplot_scipt_extension, string& output_path, string& colors_folder, const bool& saveMiddleResults, const uint& nTest, const string& middleFolder, datasetTimings& timings, asyncWriter& writer, const bool& write_n_labels = true, const bool& output_colors = true){
 
     string output_folder = input_folder,
 		   complete_output_path = output_path + kPathSeparator + output_folder,
@@ -352,6 +626,7 @@ string averages_test(vector<pair<CCLPointer, string>>& CCLAlgorithms, Mat1d& all
     Mat1d min_res(fileNumber, CCLAlgorithms.size(), numeric_limits<double>::max());
     Mat1d current_res(fileNumber, CCLAlgorithms.size(), numeric_limits<double>::max());
     Mat1i labels(fileNumber, CCLAlgorithms.size(), 0);
+    Mat1d test_totals(nTest, CCLAlgorithms.size(), 0.0);
     vector<pair<double, uint16_t>> supp_averages(CCLAlgorithms.size(), make_pair(0, 0));
 
     // Test is executed nTest times
@@ -389,7 +664,6 @@ string averages_test(vector<pair<CCLPointer, string>>& CCLAlgorithms, Mat1d& all
                 // This variables need to be redefined for every algorithms to uniform performance result (in particular this is true for labeledMat?)
                 Mat1i labeledMat;
                 unsigned nLabels;
-                Mat3b imgColors;
 
                 // Perform current algorithm on current image and save result
                 perf.start((*it).second);
@@ -402,6 +676,7 @@ string averages_test(vector<pair<CCLPointer, string>>& CCLAlgorithms, Mat1d& all
 
                 // Save time results 
                 current_res(file, i) = perf.last((*it).second);
+                test_totals(test, i) += perf.last((*it).second);
                 if (perf.last((*it).second) < min_res(file, i))
                     min_res(file, i) = perf.last((*it).second);
 
@@ -412,9 +687,13 @@ string averages_test(vector<pair<CCLPointer, string>>& CCLAlgorithms, Mat1d& all
                     string algName = (*it).second;
                     algName.erase(std::remove(algName.begin(), algName.end(), '\\'), algName.end());
 
-                    normalizeLabels(labeledMat);
-                    colorLabels(labeledMat, imgColors);
-                    imwrite(out_color_folder + kPathSeparator + filename + "_" + algName + ".png", imgColors);
+                    // Colors are computed and saved in background, the job owns the labels
+                    const string color_path = out_color_folder + kPathSeparator + filename + "_" + algName + ".png";
+                    writer.push([labeledMat, color_path](){
+                        Mat3b imgColors;
+                        colorLabels(labeledMat, imgColors);
+                        imwrite(color_path, imgColors);
+                    });
                 }
 
             }// END ALGORITHMS FOR
@@ -424,14 +703,27 @@ string averages_test(vector<pair<CCLPointer, string>>& CCLAlgorithms, Mat1d& all
         fflush(stdout);
 
         // Save middle results if necessary (falg 'at_saveMiddleTests' enable) 
-        if (saveMiddleResults){ 
-            string middleOut = middleOut_Folder + kPathSeparator + middleFile + "_" + to_string(test) + ".txt";         
-            saveBroadOutputResults(current_res, middleOut, CCLAlgorithms, write_n_labels, labels, filesNames);
+        if (saveMiddleResults){
+            string middleOut = middleOut_Folder + kPathSeparator + middleFile + "_" + to_string(test) + ".txt";
+            saveMiddleResultsAsync(writer, current_res, middleOut, CCLAlgorithms, write_n_labels, labels, filesNames);
         }
     }// END TESTS FOR
 
     // To wirte in a file min results
     saveBroadOutputResults(min_res, os_path, CCLAlgorithms, write_n_labels, labels, filesNames);
+    writer.flush();
+
+    // To export per image results in machine readable format
+    timings.dataset = input_folder;
+    timings.min_res = min_res.clone();
+    timings.labels = labels.clone();
+    timings.test_totals = test_totals.clone();
+    timings.files.clear();
+    timings.found.clear();
+    for (uint file = 0; file < filesNames.size(); ++file){
+        timings.files.push_back(filesNames[file].first);
+        timings.found.push_back(filesNames[file].second);
+    }
     
     // To calculate averages times and write it on the specified file
     for (int r = 0; r < min_res.rows; ++r){
@@ -520,7 +812,7 @@ string averages_test(vector<pair<CCLPointer, string>>& CCLAlgorithms, Mat1d& all
 	return ("Averages_Test on '" + input_folder + "': successfully done");
 }
 
-string density_size_test(vector<pair<CCLPointer, string>>& CCLAlgorithms, const string& input_path, const string& input_folder, const string& input_txt, const string& gnuplot_script_extension, string& output_path, string& colors_folder, const bool& saveMiddleResults, const uint& nTest, const string& middleFolder, const bool& write_n_labels = true, const bool& output_colors = true){
+string density_size_test(vector<pair<CCLPointer, string>>& CCLAlgorithms, const string& input_path, const string& input_folder, const string& input_txt, const string& gnuplot_script_extension, string& output_path, string& colors_folder, const bool& saveMiddleResults, const uint& nTest, const string& middleFolder, asyncWriter& writer, const bool& write_n_labels = true, const bool& output_colors = true){
 	
 	string output_folder = input_folder,
 		   complete_output_path = output_path + kPathSeparator + output_folder,
@@ -713,7 +1005,6 @@ string density_size_test(vector<pair<CCLPointer, string>>& CCLAlgorithms, const
                 // This variable need to be redefined for every algorithms to uniform performance result (in particular this is true for labeledMat?)
                 Mat1i labeledMat;
                 unsigned nLabels;
-                Mat3b imgColors;
 
                 // Note that "i" represent the current algorithm's position in vectors "supp_density" and "supp_dimension"
                 perf.start((*it).second);
@@ -734,9 +1025,13 @@ string density_size_test(vector<pair<CCLPointer, string>>& CCLAlgorithms, const
                     string algName = (*it).second;
                     algName.erase(std::remove(algName.begin(), algName.end(), '\\'), algName.end());
 
-                    normalizeLabels(labeledMat);
-                    colorLabels(labeledMat, imgColors);
-                    imwrite(out_color_folder + kPathSeparator + filename + "_" + algName + ".png", imgColors);
+                    // Colors are computed and saved in background, the job owns the labels
+                    const string color_path = out_color_folder + kPathSeparator + filename + "_" + algName + ".png";
+                    writer.push([labeledMat, color_path](){
+                        Mat3b imgColors;
+                        colorLabels(labeledMat, imgColors);
+                        imwrite(color_path, imgColors);
+                    });
                 }
             }// END ALGORTIHMS FOR
         } // END FILES FOR 
@@ -747,12 +1042,13 @@ string density_size_test(vector<pair<CCLPointer, string>>& CCLAlgorithms, const
         // Save middle results if necessary (falg 'at_saveMiddleTests' enable) 
         if (saveMiddleResults){
             string middleOut = middleOut_Folder + kPathSeparator + middleFile + "_" + to_string(test) + ".txt";
-            saveBroadOutputResults(current_res, middleOut, CCLAlgorithms, write_n_labels, labels, filesNames);
+            saveMiddleResultsAsync(writer, current_res, middleOut, CCLAlgorithms, write_n_labels, labels, filesNames);
         }
 	}// END TEST FOR
 
     // To wirte in a file min results
     saveBroadOutputResults(min_res, os_path, CCLAlgorithms, write_n_labels, labels, filesNames);
+    writer.flush();
     
     // To sum min results, in the correct manner, before make averages
     for (unsigned int files = 0; files < filesNames.size(); ++files){
@@ -1009,10 +1305,395 @@ string density_size_test(vector<pair<CCLPointer, string>>& CCLAlgorithms, const
 	return ("Density_Size_Test on '" + output_folder + "': successfuly done");
 }
 
-string memory_test(vector<pair<CCLMemPointer, string>>& CCLMemAlgorithms, Mat1d& algo_averages_accesses, const string& input_path, const string& input_folder, const string& input_txt, string& output_path){
+// To write in a gnuplot script a colors and a black and white graph with one line for every algorithm 
+void writeLinesGraph(ofstream& scriptos, const string& data_file, const string& output_graph, const string& output_graph_bw, const string& xlabel, const string& ylabel, const string& logscale, const vector<pair<CCLPointer, string>>& CCLAlgorithms){
+
+	scriptos << "# " << data_file << " (COLORS)" << endl << endl;
+	scriptos << "set output \"" + output_graph + "\"" << endl;
+	scriptos << "# " << terminal << " colors" << endl;
+	scriptos << "set terminal " << terminal << " enhanced color font ',15'" << endl << endl;
+
+	scriptos << "# Axes labels" << endl;
+	scriptos << "set xlabel \"" << xlabel << "\"" << endl;
+	scriptos << "set ylabel \"" << ylabel << "\"" << endl << endl;
+
+	scriptos << "# Axes range" << endl;
+	scriptos << "set xrange [*:*]" << endl;
+	scriptos << "set yrange [*:*]" << endl;
+	scriptos << "unset logscale" << endl;
+	if (!logscale.empty())
+		scriptos << "set logscale " << logscale << endl;
+	scriptos << endl;
+
+	scriptos << "# Legend" << endl;
+	scriptos << "set key left top nobox spacing 2 font ', 8'" << endl << endl;
+
+	scriptos << "# Plot" << endl;
+	scriptos << "plot \\" << endl;
+	for (unsigned int i = 0; i < CCLAlgorithms.size(); ++i){
+		scriptos << "\"" + data_file + "\" using 1:" << (i + 2) << " with linespoints title \"" + CCLAlgorithms[i].second + "\"";
+		scriptos << ((i + 1 < CCLAlgorithms.size()) ? " , \\" : "") << endl;
+	}
+	scriptos << endl;
+
+	scriptos << "# " << data_file << " (BLACK AND WHITE)" << endl << endl;
+	scriptos << "set output \"" + output_graph_bw + "\"" << endl;
+	scriptos << "# " << terminal << " black and white" << endl;
+	scriptos << "set terminal " << terminal << " enhanced monochrome dashed font ',15'" << endl << endl;
+	scriptos << "replot" << endl << endl;
+}
+
+// splitmix64 step: mixes 'value' into 'hash', so that different tuples of values give unrelated hashes
+static inline uint64_t splitmix64(uint64_t hash, uint64_t value){
+	uint64_t z = hash + value + 0x9E3779B97F4A7C15ull;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
+}
+
+// Seed of the synthetic image of a texture, size and density (the bits of the density are hashed, not a rounding of it)
+static uint64_t syntheticSeed(uint64_t seed, texturetype texture, int size, double density){
+	uint64_t density_bits;
+	memcpy(&density_bits, &density, sizeof(density_bits));
+	return splitmix64(splitmix64(splitmix64(seed, (uint64_t)texture), (uint64_t)size), density_bits);
+}
+
+// Like density_size_test but on images generated in memory by 'generateImage', so that sizes and densities 
+// are not limited to the ones of the 'test_random' dataset. For every texture two files are written: 
+// '<texture>_size.txt' (minimum execution time averaged over densities, for every size) and 
+// '<texture>_density.txt' (execution time per megapixel averaged over sizes, for every density)
+string synthetic_test(vector<pair<CCLPointer, string>>& CCLAlgorithms, const vector<string>& textures, const vector<int>& sizes, const vector<double>& densities, const unsigned long long& seed, const string& gnuplot_script_extension, string& output_path, const uint& nTest){
+
+	string output_folder = "synthetic",
+		   complete_output_path = output_path + kPathSeparator + output_folder,
+		   gnuplot_script = output_folder + gnuplot_script_extension;
+
+	// Creation of output path
+	if (!makeDir(complete_output_path))
+		return ("Synthetic_Test: Unable to find/create the output path " + complete_output_path);
+
+	// GNUPLOT SCRIPT
+	string scriptos_path = complete_output_path + kPathSeparator + gnuplot_script;
+	ofstream scriptos(scriptos_path);
+	if (!scriptos.is_open())
+		return ("Synthetic_Test: Unable to create " + scriptos_path);
+
+	scriptos << "# This is a gnuplot (http://www.gnuplot.info/) script!" << endl;
+	scriptos << "# comment fifth line, open gnuplot's teminal, move to script's path and launch 'load " << gnuplot_script << "' if you want to run it" << endl << endl;
+
+	scriptos << "reset" << endl;
+	scriptos << "cd '" << complete_output_path << "\'" << endl;
+	scriptos << "set grid" << endl << endl;
+
+	for (uint t = 0; t < textures.size(); ++t){
+
+		texturetype texture;
+		if (!textureFromName(textures[t], texture)){
+			cout << "Unable to find '" << textures[t] << "' texture, skipped" << endl;
+			continue;
+		}
+
+		string output_size_result = textures[t] + "_size.txt",
+			   output_density_result = textures[t] + "_density.txt";
+
+		ofstream size_os(complete_output_path + kPathSeparator + output_size_result);
+		if (!size_os.is_open())
+			return ("Synthetic_Test: Unable to create " + output_size_result);
+		ofstream density_os(complete_output_path + kPathSeparator + output_density_result);
+		if (!density_os.is_open())
+			return ("Synthetic_Test: Unable to create " + output_density_result);
+
+		// Sums of minimum times: rows represent sizes (or densities), columns represent algorithms
+		Mat1d size_res(sizes.size(), CCLAlgorithms.size(), 0.0);
+		Mat1d density_res(densities.size(), CCLAlgorithms.size(), 0.0);
+
+		// Count number of generated images to display "progress bar"
+		uint currentNumber = 0, imagesNumber = sizes.size() * densities.size();
+
+		PerformanceEvaluator perf;
+		for (uint s = 0; s < sizes.size(); ++s){
+			for (uint d = 0; d < densities.size(); ++d){
+
+				cout << textures[t] << ": " << currentNumber++ << "/" << imagesNumber << "         \r";
+				fflush(stdout);
+
+				// Every image has its own seed, which depends on the texture (not on its position in the list), on the 
+				// size and on the density, so that adding or reordering textures, sizes or densities does not change the others
+				Mat1b binaryImg;
+				generateImage(texture, sizes[s], sizes[s], densities[d], syntheticSeed(seed, texture, sizes[s], densities[d]), binaryImg);
+				const double megapixels = (double)sizes[s] * sizes[s] / 1000000;
+
+				unsigned int i = 0;
+				// For all the Algorithms in the array
+				for (auto it = CCLAlgorithms.begin(); it != CCLAlgorithms.end(); ++it, ++i){
+					double min_time = numeric_limits<double>::max();
+					// Test is executed nTest times
+					for (uint test = 0; test < nTest; ++test){
+						Mat1i labeledMat;
+						perf.start((*it).second);
+						(*it).first(binaryImg, labeledMat);
+						perf.stop((*it).second);
+						min_time = min(min_time, perf.last((*it).second));
+					}
+					size_res(s, i) += min_time;
+					density_res(d, i) += min_time / megapixels;
+				}// END ALGORITHMS FOR
+			}// END DENSITIES FOR
+		}// END SIZES FOR
+		cout << textures[t] << ": " << currentNumber << "/" << imagesNumber << "         " << endl;
+
+		// To set heading file format (SIZE RESULT, DENSITY RESULT)
+		size_os << "#Size";
+		density_os << "#Density";
+		for (vector<pair<CCLPointer, string>>::iterator it = CCLAlgorithms.begin(); it != CCLAlgorithms.end(); ++it){
+			size_os << "\t" << (*it).second;
+			density_os << "\t" << (*it).second;
+		}
+		size_os << endl;
+		density_os << endl;
+
+		// To write size result (averages on densities) on specified file
+		for (uint s = 0; s < sizes.size(); ++s){
+			size_os << (double)sizes[s] * sizes[s];
+			for (int i = 0; i < size_res.cols; ++i){
+				size_os << "\t" << size_res(s, i) / densities.size();
+			}
+			size_os << endl;
+		}
+
+		// To write density result (averages on sizes) on specified file
+		for (uint d = 0; d < densities.size(); ++d){
+			density_os << densities[d];
+			for (int i = 0; i < density_res.cols; ++i){
+				density_os << "\t" << density_res(d, i) / sizes.size();
+			}
+			density_os << endl;
+		}
+
+		size_os.close();
+		density_os.close();
+
+		writeLinesGraph(scriptos, output_size_result, textures[t] + "_size" + terminalExtension, textures[t] + "_size_bw" + terminalExtension, "Pixels", "Execution Time [ms]", "xy 10", CCLAlgorithms);
+		writeLinesGraph(scriptos, output_density_result, textures[t] + "_density" + terminalExtension, textures[t] + "_density_bw" + terminalExtension, "Density", "Execution Time per Megapixel [ms]", "", CCLAlgorithms);
+	}// END TEXTURES FOR
+
+	scriptos << "exit gnuplot" << endl;
+	scriptos.close();
+	// GNUPLOT SCRIPT
+
+	if (0 != std::system(("gnuplot " + complete_output_path + kPathSeparator + gnuplot_script).c_str()))
+		return ("Synthetic_Test: Unable to run gnuplot's script");
+	return ("Synthetic_Test: successfuly done");
+}
+
+// To detect super-linear behaviour of the algorithms on adversarial patterns for equivalence resolution. For 
+// every texture and size the minimum execution time is normalized by the number of pixels: a linear algorithm 
+// has a flat curve. The growth exponent of time with respect to the number of pixels is estimated by least 
+// squares on log-log values and algorithms whose exponent exceeds 1 + tolerance are reported.
+string pathological_test(vector<pair<CCLPointer, string>>& CCLAlgorithms, const vector<string>& textures, const vector<int>& sizes, const double& tolerance, const string& gnuplot_script_extension, string& output_path, const uint& nTest){
+
+	string output_folder = "pathological",
+		   complete_output_path = output_path + kPathSeparator + output_folder,
+		   gnuplot_script = output_folder + gnuplot_script_extension,
+		   summary_os_path = complete_output_path + kPathSeparator + "growth_summary.txt";
+
+	// Creation of output path
+	if (!makeDir(complete_output_path))
+		return ("Pathological_Test: Unable to find/create the output path " + complete_output_path);
+
+	ofstream summary_os(summary_os_path);
+	if (!summary_os.is_open())
+		return ("Pathological_Test: Unable to create " + summary_os_path);
+	summary_os << "#Texture\tAlgorithm\tGrowth_Exponent\tMax_Local_Exponent\tSuper_Linear" << endl;
+
+	// GNUPLOT SCRIPT
+	string scriptos_path = complete_output_path + kPathSeparator + gnuplot_script;
+	ofstream scriptos(scriptos_path);
+	if (!scriptos.is_open())
+		return ("Pathological_Test: Unable to create " + scriptos_path);
+
+	scriptos << "# This is a gnuplot (http://www.gnuplot.info/) script!" << endl;
+	scriptos << "# comment fifth line, open gnuplot's teminal, move to script's path and launch 'load " << gnuplot_script << "' if you want to run it" << endl << endl;
+
+	scriptos << "reset" << endl;
+	scriptos << "cd '" << complete_output_path << "\'" << endl;
+	scriptos << "set grid" << endl << endl;
+
+	bool super_linear = false;
+	for (uint t = 0; t < textures.size(); ++t){
+
+		texturetype texture;
+		if (!textureFromName(textures[t], texture)){
+			cout << "Unable to find '" << textures[t] << "' texture, skipped" << endl;
+			continue;
+		}
+
+		string output_growth_result = textures[t] + "_growth.txt";
+		ofstream growth_os(complete_output_path + kPathSeparator + output_growth_result);
+		if (!growth_os.is_open())
+			return ("Pathological_Test: Unable to create " + output_growth_result);
+
+		// Minimum times: rows represent sizes, columns represent algorithms
+		Mat1d min_res(sizes.size(), CCLAlgorithms.size(), numeric_limits<double>::max());
+
+		PerformanceEvaluator perf;
+		for (uint s = 0; s < sizes.size(); ++s){
+
+			cout << textures[t] << ": " << s << "/" << sizes.size() << "         \r";
+			fflush(stdout);
+
+			Mat1b binaryImg;
+			generateImage(texture, sizes[s], sizes[s], 0, 0, binaryImg);
+
+			unsigned int i = 0;
+			// For all the Algorithms in the array
+			for (auto it = CCLAlgorithms.begin(); it != CCLAlgorithms.end(); ++it, ++i){
+				// Test is executed nTest times
+				for (uint test = 0; test < nTest; ++test){
+					Mat1i labeledMat;
+					perf.start((*it).second);
+					(*it).first(binaryImg, labeledMat);
+					perf.stop((*it).second);
+					min_res(s, i) = min(min_res(s, i), perf.last((*it).second));
+				}
+			}// END ALGORITHMS FOR
+		}// END SIZES FOR
+		cout << textures[t] << ": " << sizes.size() << "/" << sizes.size() << "         " << endl;
+
+		// To write time per pixel (in ns) for every size
+		growth_os << "#Pixels";
+		for (vector<pair<CCLPointer, string>>::iterator it = CCLAlgorithms.begin(); it != CCLAlgorithms.end(); ++it){
+			growth_os << "\t" << (*it).second;
+		}
+		growth_os << endl;
+		for (uint s = 0; s < sizes.size(); ++s){
+			const double pixels = (double)sizes[s] * sizes[s];
+			growth_os << pixels;
+			for (int i = 0; i < min_res.cols; ++i){
+				growth_os << "\t" << min_res(s, i) * 1000000 / pixels;
+			}
+			growth_os << endl;
+		}
+		growth_os.close();
+
+		// Growth exponent: slope of the least squares line fitting (log(pixels), log(time))
+		for (int i = 0; i < min_res.cols; ++i){
+			double sx = 0, sy = 0, sxx = 0, sxy = 0, max_local = 0;
+			for (uint s = 0; s < sizes.size(); ++s){
+				const double x = log((double)sizes[s] * sizes[s]), y = log(min_res(s, i));
+				sx += x; sy += y; sxx += x * x; sxy += x * y;
+				if (s > 0){
+					const double local = (y - log(min_res(s - 1, i))) / (x - log((double)sizes[s - 1] * sizes[s - 1]));
+					max_local = max(max_local, local);
+				}
+			}
+			const double n = sizes.size(),
+						 exponent = (n * sxy - sx * sy) / (n * sxx - sx * sx);
+			const bool flag = exponent > 1 + tolerance;
+			super_linear = super_linear || flag;
+
+			summary_os << textures[t] << "\t" << CCLAlgorithms[i].second << "\t" << exponent << "\t" << max_local << "\t" << (flag ? "yes" : "no") << endl;
+			if (flag)
+				cout << "WARNING: '" << CCLAlgorithms[i].second << "' grows super-linearly on '" << textures[t] << "' (exponent " << exponent << ")" << endl;
+		}
+
+		writeLinesGraph(scriptos, output_growth_result, textures[t] + "_growth" + terminalExtension, textures[t] + "_growth_bw" + terminalExtension, "Pixels", "Execution Time per Pixel [ns]", "x 10", CCLAlgorithms);
+	}// END TEXTURES FOR
+
+	scriptos << "exit gnuplot" << endl;
+	scriptos.close();
+	summary_os.close();
+	// GNUPLOT SCRIPT
+
+	if (0 != std::system(("gnuplot " + complete_output_path + kPathSeparator + gnuplot_script).c_str()))
+		return ("Pathological_Test: Unable to run gnuplot's script");
+	if (super_linear)
+		return ("Pathological_Test: done, super-linear growth detected (see " + summary_os_path + ")");
+	return ("Pathological_Test: successfuly done");
+}
+
+// Instrumentation of memory tests
+struct memoryTestOptions{
+	cacheModel *cache;				// Cache model fed by the algorithms, nullptr to disable it
+	bool record_traces;				// Record the accesses of every algorithm on every image
+	memgranularity granularity;		// Granularity of the access counters
+	unsigned sampling;				// Count one access every 'sampling' on average (1 counts all of them)
+	unsigned threads;				// Images processed in parallel, 0 for one for every hardware thread
+	bool save_heatmaps;				// Save reads and writes of every matrix of every algorithm on every image
+};
+
+// Name of the data structures in the memory tests output files
+static string memoryDataTypeName(memorydatatype type){
+	switch (type){
+	case MD_BINARY_MAT: return "binary";
+	case MD_LABELED_MAT: return "labels";
+	case MD_EQUIVALENCE_VEC: return "equivalences";
+	default: return "other";
+	}
+}
+
+// To save the accesses to a matrix: heatmaps of reads and writes of every element ("<prefix>_reads.png" and "<prefix>_writes.png", 
+// with the same color scale) and reads and writes of every row ("<prefix>.csv"). Heatmaps need counters of elements, and rows need 
+// counters of elements or rows: with counters of memory lines the csv file lists lines instead of rows. With sampling counters 
+// of elements cover blocks of adjacent columns, so heatmaps are narrower than the matrix.
+static void saveAccessesHeatmaps(const string& prefix, const memAccessesReport& report){
+
+	if (report.granularity == MG_ELEMENTS){
+		Mat1d reads(report.rows, report.counters_cols), writes(report.rows, report.counters_cols);
+		copy(report.reads_counts.begin(), report.reads_counts.end(), reads.ptr<double>(0));
+		copy(report.writes_counts.begin(), report.writes_counts.end(), writes.ptr<double>(0));
+
+		double max_reads = 0, max_writes = 0;
+		minMaxLoc(reads, nullptr, &max_reads);
+		minMaxLoc(writes, nullptr, &max_writes);
+		const double scale = 255. / max(max(max_reads, max_writes), 1.);
+
+		Mat1b gray;
+		Mat3b heatmap;
+		reads.convertTo(gray, CV_8U, scale);
+		applyColorMap(gray, heatmap, COLORMAP_JET);
+		imwrite(prefix + "_reads.png", heatmap);
+		writes.convertTo(gray, CV_8U, scale);
+		applyColorMap(gray, heatmap, COLORMAP_JET);
+		imwrite(prefix + "_writes.png", heatmap);
+	}
+
+	ofstream os(prefix + ".csv");
+	if (!os.is_open()){
+		cout << "Unable to open/create " + prefix + ".csv" << endl;
+		return;
+	}
+	const bool lines = report.granularity == MG_LINES;
+	const size_t counters_per_row = report.granularity == MG_ELEMENTS ? report.counters_cols : 1;
+	const size_t rows = lines ? report.reads_counts.size() : report.rows;
+	os << (lines ? "line" : "row") << ",reads,writes" << endl;
+	for (size_t r = 0; r < rows; ++r){
+		double reads = 0, writes = 0;
+		for (size_t c = r * counters_per_row; c < (r + 1) * counters_per_row; ++c){
+			reads += report.reads_counts[c];
+			writes += report.writes_counts[c];
+		}
+		os << r << "," << reads << "," << writes << endl;
+	}
+}
+
+// 'algo_averages_errors' stores the standard error of the average accesses due to sampling (zero without sampling), 
+// 'algo_averages_writes' and 'algo_averages_writes_errors' store the part of the accesses which are writes and its error.
+// If 'options.cache' is not null every algorithm also feeds the cache model, which is emptied before every image: 
+// 'algo_averages_hits' and 'algo_averages_misses' store average hits and misses (rows represent algorithms, 
+// columns represent data structures of the first cache level, then of the second and so on). If 'options.record_traces'
+// is true the accesses of every algorithm on every image are recorded in "<output>/<dataset>/traces/<image>_<algorithm>.trace". 
+// If 'options.save_heatmaps' is true reads and writes of every matrix are saved in "<output>/<dataset>/heatmaps/<image>_<algorithm>_<matrix>"
+// (see saveAccessesHeatmaps)
+string memory_test(vector<pair<CCLMemPointer, string>>& CCLMemAlgorithms, Mat1d& algo_averages_accesses, Mat1d& algo_averages_errors, Mat1d& algo_averages_writes, Mat1d& algo_averages_writes_errors, const string& input_path, const string& input_folder, const string& input_txt, string& output_path, const memoryTestOptions& options, Mat1d& algo_averages_hits, Mat1d& algo_averages_misses){
+
+	cacheModel *cache = options.cache;
+	const bool record_traces = options.record_traces;
 
 	string output_folder = input_folder,
-		   complete_output_path = output_path + kPathSeparator + output_folder;
+		   complete_output_path = output_path + kPathSeparator + output_folder,
+		   traces_path = complete_output_path + kPathSeparator + "traces",
+		   heatmaps_path = complete_output_path + kPathSeparator + "heatmaps";
 		   
 	uint number_of_decimal_digit_to_display_in_graph = 2;
 
@@ -1020,6 +1701,12 @@ string memory_test(vector<pair<CCLMemPointer, string>>& CCLMemAlgorithms, Mat1d&
 	if(!makeDir(complete_output_path))
 		return ("Memory_Test on '" + input_folder + "': Unable to find/create the output path " + complete_output_path);
 
+	if (record_traces && !makeDir(traces_path))
+		return ("Memory_Test on '" + input_folder + "': Unable to find/create the output path " + traces_path);
+
+	if (options.save_heatmaps && !makeDir(heatmaps_path))
+		return ("Memory_Test on '" + input_folder + "': Unable to find/create the output path " + heatmaps_path);
+
 	string is_path = input_path + kPathSeparator + input_folder + kPathSeparator + input_txt;
 
 	// For LIST OF INPUT IMAGES
@@ -1051,16 +1738,222 @@ string memory_test(vector<pair<CCLMemPointer, string>>& CCLMemAlgorithms, Mat1d&
 
 	// To store averages memory accesses (one column for every data structure type: col 1 -> BINARY_MAT, col 2 -> LABELED_MAT, col 3 -> EQUIVALENCE_VET, col 0 -> OTHER)
 	algo_averages_accesses = Mat1d(Size(MD_SIZE, CCLMemAlgorithms.size()), 0);
+	algo_averages_errors = Mat1d(Size(MD_SIZE, CCLMemAlgorithms.size()), 0);
+	algo_averages_writes = Mat1d(Size(MD_SIZE, CCLMemAlgorithms.size()), 0);
+	algo_averages_writes_errors = Mat1d(Size(MD_SIZE, CCLMemAlgorithms.size()), 0);
+	const int cache_cols = cache ? (int)cache->levels() * MD_SIZE : 0;
+	algo_averages_hits = Mat1d(Size(cache_cols, CCLMemAlgorithms.size()), 0);
+	algo_averages_misses = Mat1d(Size(cache_cols, CCLMemAlgorithms.size()), 0);
+
+	// Images are processed in parallel, every worker with its own cache model. Results of every image are 
+	// stored apart and summed in file order at the end, so they do not depend on the number of workers.
+	vector<Mat1d> file_accesses(fileNumber), file_writes(fileNumber), file_hits(fileNumber), file_misses(fileNumber);
+	vector<cacheModel> caches;
+	if (cache)
+		caches = vector<cacheModel>(workersNumber(options.threads), *cache);
 
 	// Count number of lines to display "progress bar"
-	uint currentNumber = 0;
+	atomic<uint> currentNumber(0);
+	mutex output_mutex;
+
+	parallelFor(filesNames.size(), options.threads, [&](size_t file, unsigned worker){
+
+		string filename = filesNames[file].first;
+		cacheModel *worker_cache = cache ? &caches[worker] : nullptr;
+
+		Mat1b binaryImg;
+		bool found = getBinaryImage(input_path + kPathSeparator + input_folder + kPathSeparator + filename, binaryImg);
+
+		if (found){
+			file_accesses[file] = Mat1d(Size(MD_SIZE, CCLMemAlgorithms.size()), 0);
+			file_writes[file] = Mat1d(Size(MD_SIZE, CCLMemAlgorithms.size()), 0);
+			file_hits[file] = Mat1d(Size(cache_cols, CCLMemAlgorithms.size()), 0);
+			file_misses[file] = Mat1d(Size(cache_cols, CCLMemAlgorithms.size()), 0);
+
+			uint i = 0;
+			// For all the Algorithms in the list
+			for (auto it = CCLMemAlgorithms.begin(); it != CCLMemAlgorithms.end(); ++it, ++i){
+
+				// The following data structure is used to get the memory access matrixes
+				vector<unsigned long int> accessesVal; // Rows represents algorithms and columns represent data structures
+				uint nLabels;
+
+				// Sampling depends only on the image and on the algorithm
+				memoryContext().granularity = options.granularity;
+				memoryContext().sampling = options.sampling;
+				memoryContext().write_counters = options.save_heatmaps;
+				memoryContext().reseed((uint64_t)file * CCLMemAlgorithms.size() + i);
+
+				if (worker_cache){
+					// Cold cache for every image
+					worker_cache->reset();
+					memoryContext().activate(worker_cache);
+				}
+
+				// Remove gnuplot excape character from output filename
+				string algName = (*it).second;
+				algName.erase(std::remove(algName.begin(), algName.end(), '\\'), algName.end());
+
+				// Data structures report reads and writes when they are destroyed
+				memCollector collector;
+				collector.details = options.save_heatmaps;
+				memoryContext().collector = &collector;
+
+				traceWriter trace;
+				if (record_traces){
+					string trace_file = traces_path + kPathSeparator + filename + "_" + algName + ".trace";
+					if (trace.open(trace_file))
+						memoryContext().trace = &trace;
+					else{
+						lock_guard<mutex> lock(output_mutex);
+						cout << "Unable to open/create " + trace_file << endl;
+					}
+				}
+
+				nLabels = (*it).first(binaryImg, accessesVal);
+
+				memoryContext().trace = nullptr;
+				memoryContext().collector = nullptr;
+				trace.close();
+
+				// For every data structure "returned" by the algorithm
+				for (size_t a = 0; a < accessesVal.size(); ++a){
+					file_accesses[file](i, a) = accessesVal[a];
+				}
+
+				for (const memAccessesReport& report : collector.reports){
+					file_writes[file](i, report.type) += report.writes;
+					if (options.save_heatmaps && report.rows > 0)
+						saveAccessesHeatmaps(heatmaps_path + kPathSeparator + filename + "_" + algName + "_" + memoryDataTypeName(report.type), report);
+				}
+
+				if (worker_cache){
+					memoryContext().activate(nullptr);
+					for (size_t l = 0; l < worker_cache->levels(); ++l){
+						for (int a = 0; a < MD_SIZE; ++a){
+							file_hits[file](i, l * MD_SIZE + a) = worker_cache->hits(l, a);
+							file_misses[file](i, l * MD_SIZE + a) = worker_cache->misses(l, a);
+						}
+					}
+				}
+			}// END ALGORITHMS FOR
+		}
+
+		// Display "progress bar"
+		lock_guard<mutex> lock(output_mutex);
+		if (!found && filesNames[file].second)
+			cout << "'" + filename + "' does not exist" << endl;
+		if (!found)
+			filesNames[file].second = false;
+		uint done = ++currentNumber;
+		if (done * 100 / fileNumber != (done - 1) * 100 / fileNumber){
+			cout << done << "/" << fileNumber << "         \r";
+			fflush(stdout);
+		}
+	}); // END FILES FOR
 
 	uint totTest = 0; // To count the real number of image on which labeling will be applied
+	for (int file = 0; file < fileNumber; ++file){
+		if (file_accesses[file].empty())
+			continue;
+		totTest++;
+		for (int i = 0; i < algo_averages_accesses.rows; ++i){
+			for (int a = 0; a < MD_SIZE; ++a){
+				algo_averages_accesses(i, a) += file_accesses[file](i, a);
+				// Variances of the estimates of different images add up
+				const double error = sampledAccessesError(file_accesses[file](i, a), options.sampling);
+				algo_averages_errors(i, a) += error * error;
+				algo_averages_writes(i, a) += file_writes[file](i, a);
+				const double writes_error = sampledAccessesError(file_writes[file](i, a), options.sampling);
+				algo_averages_writes_errors(i, a) += writes_error * writes_error;
+			}
+			for (int c = 0; c < cache_cols; ++c){
+				algo_averages_hits(i, c) += file_hits[file](i, c);
+				algo_averages_misses(i, c) += file_misses[file](i, c);
+			}
+		}
+	}
+
+	// To display "progress bar"
+	cout << currentNumber << "/" << fileNumber << "         \r";
+	fflush(stdout);
+
+	// To calculate average memory accesses
+	for (int r = 0; r < algo_averages_accesses.rows; ++r){
+		for (int c = 0; c < algo_averages_accesses.cols; ++c){
+			algo_averages_accesses(r, c) /= totTest; 
+			algo_averages_errors(r, c) = sqrt(algo_averages_errors(r, c)) / totTest;
+			algo_averages_writes(r, c) /= totTest;
+			algo_averages_writes_errors(r, c) = sqrt(algo_averages_writes_errors(r, c)) / totTest;
+		}
+		for (int c = 0; c < cache_cols; ++c){
+			algo_averages_hits(r, c) /= totTest;
+			algo_averages_misses(r, c) /= totTest;
+		}
+	}
+	
+	return ("Memory_Test on '" + input_folder + "': successfuly done");
+}
+
+// To collect engines' internal counters (provisional labels, unions, findRoot path lengths, relinks and BBDT 
+// leaves hits) for every image, together with the execution time of the same run
+string counters_test(vector<pair<CCLPointer, string>>& CCLAlgorithms, const string& input_path, const string& input_folder, const string& input_txt, string& output_path){
+
+	string output_folder = input_folder,
+		   complete_output_path = output_path + kPathSeparator + output_folder,
+		   output_counters = input_folder + "_counters.txt",
+		   output_actions = input_folder + "_bbdt_actions.txt";
+
+	// Creation of output path
+	if (!makeDir(complete_output_path))
+		return ("Counters_Test on '" + input_folder + "': Unable to find/create the output path " + complete_output_path);
+
+	string is_path = input_path + kPathSeparator + input_folder + kPathSeparator + input_txt,
+		   counters_os_path = complete_output_path + kPathSeparator + output_counters,
+		   actions_os_path = complete_output_path + kPathSeparator + output_actions;
+
+	// For LIST OF INPUT IMAGES
+	ifstream is(is_path);
+	if (!is.is_open())
+		return ("Counters_Test on '" + input_folder + "': Unable to open " + is_path);
+	// For PER IMAGE COUNTERS
+	ofstream counters_os(counters_os_path);
+	if (!counters_os.is_open())
+		return ("Counters_Test on '" + input_folder + "': Unable to create " + counters_os_path);
+	// For BBDT LEAVES HISTOGRAM
+	ofstream actions_os(actions_os_path);
+	if (!actions_os.is_open())
+		return ("Counters_Test on '" + input_folder + "': Unable to create " + actions_os_path);
+
+	vector<string> filesNames;
+	string filename;
+	while (getline(is, filename)){
+		deleteCarriageReturn(filename);
+		filesNames.push_back(filename);
+	}
+	is.close();
+
+	// Number of files
+	int fileNumber = filesNames.size();
+
+	// To set heading file format (one group of columns for every algorithm)
+	counters_os << "#File";
+	for (vector<pair<CCLPointer, string>>::iterator it = CCLAlgorithms.begin(); it != CCLAlgorithms.end(); ++it){
+		counters_os << "\t" << (*it).second << "_time" << "\t" << (*it).second << "_provisional_labels" << "\t" << (*it).second << "_unions";
+		counters_os << "\t" << (*it).second << "_findRoot_steps" << "\t" << (*it).second << "_relink_steps";
+	}
+	counters_os << endl;
+
+	// BBDT decision tree leaves hits summed on the whole dataset, for every algorithm
+	vector<vector<unsigned long long>> actions(CCLAlgorithms.size(), vector<unsigned long long>(BBDT_ACTIONS_SIZE, 0));
+
+	// Count number of lines to display "progress bar"
+	uint currentNumber = 0;
+
+	PerformanceEvaluator perf;
 	// For every file in list
 	for (uint file = 0; file < filesNames.size(); ++file){
 
-		string filename = filesNames[file].first;
-
 		// Display "progress bar"
 		if (currentNumber * 100 / fileNumber != (currentNumber - 1) * 100 / fileNumber){
 			cout << currentNumber << "/" << fileNumber << "         \r";
@@ -1070,45 +1963,57 @@ string memory_test(vector<pair<CCLMemPointer, string>>& CCLMemAlgorithms, Mat1d&
 
 		Mat1b binaryImg;
 
-		if (!getBinaryImage(input_path + kPathSeparator + input_folder + kPathSeparator + filename, binaryImg)){
-			if (filesNames[file].second)
-				cout << "'" + filename + "' does not exist" << endl;
-			filesNames[file].second = false;
+		if (!getBinaryImage(input_path + kPathSeparator + input_folder + kPathSeparator + filesNames[file], binaryImg)){
+			cout << "'" + filesNames[file] + "' does not exist" << endl;
 			continue;
 		}
 
-		totTest++;
+		counters_os << filesNames[file];
 		uint i = 0;
 		// For all the Algorithms in the list
-		for (auto it = CCLMemAlgorithms.begin(); it != CCLMemAlgorithms.end(); ++it, ++i){
+		for (auto it = CCLAlgorithms.begin(); it != CCLAlgorithms.end(); ++it, ++i){
 
-			// The following data structure is used to get the memory access matrixes
-			vector<unsigned long int> accessesVal; // Rows represents algorithms and columns represent data structures
-			uint nLabels;
+			Mat1i labeledMat;
 
-			nLabels = (*it).first(binaryImg, accessesVal);
+			cclCounters().reset();
+			perf.start((*it).second);
+			(*it).first(binaryImg, labeledMat);
+			perf.stop((*it).second);
 
-			// For every data structure "returned" by the algorithm
-			for (size_t a = 0; a < accessesVal.size(); ++a){
-				algo_averages_accesses(i, a) += accessesVal[a];
+			const labelingCounters &counters = cclCounters();
+			counters_os << "\t" << perf.last((*it).second);
+			for (int c = 0; c < CT_SIZE; ++c){
+				counters_os << "\t" << counters.events[c];
+			}
+			for (int a = 0; a < BBDT_ACTIONS_SIZE; ++a){
+				actions[i][a] += counters.bbdtActions[a];
 			}
 		}// END ALGORITHMS FOR
+		counters_os << endl;
 	} // END FILES FOR
 
 	// To display "progress bar"
 	cout << currentNumber << "/" << fileNumber << "         \r";
 	fflush(stdout);
 
-	// To calculate average memory accesses
-	for (int r = 0; r < algo_averages_accesses.rows; ++r){
-		for (int c = 0; c < algo_averages_accesses.cols; ++c){
-			algo_averages_accesses(r, c) /= totTest; 
+	// To write BBDT leaves histogram (only algorithms which walk the BBDT tree have non-zero columns)
+	actions_os << "#Action";
+	for (vector<pair<CCLPointer, string>>::iterator it = CCLAlgorithms.begin(); it != CCLAlgorithms.end(); ++it){
+		actions_os << "\t" << (*it).second;
+	}
+	actions_os << endl;
+	for (int a = 1; a < BBDT_ACTIONS_SIZE; ++a){
+		actions_os << a;
+		for (unsigned int i = 0; i < CCLAlgorithms.size(); ++i){
+			actions_os << "\t" << actions[i][a];
 		}
+		actions_os << endl;
 	}
-	
-	return ("Memory_Test on '" + input_folder + "': successfuly done");
+
+	return ("Counters_Test on '" + input_folder + "': successfuly done");
 }
 
+
 // To generate latex table with averages results
 void generateLatexTable(const string& output_path, const string& latex_file, const Mat1d& all_res, const vector<string>& algName, const vector<pair<CCLPointer, string>>& CCLAlgorithms){
     
@@ -1160,8 +2065,9 @@ void generateLatexTable(const string& output_path, const string& latex_file, con
     is.close(); 
 }
 
-// To generate latex table with memory average accesses
-void generateMemoryLatexTable(const string& output_path, const string& latex_file, const Mat1d& accesses,const string& dataset, const vector<pair<CCLMemPointer, string>>& CCLMemAlgorithms){
+// To generate latex table with memory average accesses ('kind' is "accesses", or "writes" for a table of writes only)
+// If 'sampling' is greater than 1 accesses are estimates, and their standard errors ('errors') are reported too
+void generateMemoryLatexTable(const string& output_path, const string& latex_file, const Mat1d& accesses, const Mat1d& errors, const unsigned sampling, const string& dataset, const vector<pair<CCLMemPointer, string>>& CCLMemAlgorithms, const string& kind = "accesses"){
 
 	// TODO handle if folder does not exists
 	string latex_path = output_path + kPathSeparator + dataset + kPathSeparator + latex_file;
@@ -1179,17 +2085,20 @@ void generateMemoryLatexTable(const string& output_path, const string& latex_fil
 	is << "%\\usepackage{siunitx}" << endl << endl;
 	is << "\\begin{table}[tbh]" << endl << endl;
 	is << "\t\\centering" << endl;
-	is << "\t\\caption{Analysis of memory accesses required by connected components computation for '" << dataset << "' dataset. The numbers are given in millions of accesses}" << endl;
+	is << "\t\\caption{Analysis of memory " << kind << " required by connected components computation for '" << dataset << "' dataset. The numbers are given in millions of " << kind;
+	if (sampling > 1)
+		is << ", estimated counting one access every " << sampling << " (with standard errors)";
+	is << "}" << endl;
 	is << "\t\\label{tab:table1}" << endl;
 	is << "\t\\begin{tabular}{|l|";
 	for (int i = 0; i < accesses.cols + 1; ++i)
-		is << "S[table-format=2.3]|";
+		is << (sampling > 1 ? "S[table-format=2.3(3)]|" : "S[table-format=2.3]|");
 	is << "}" << endl;
 	is << "\t\\hline" << endl;
 	is << "\t";
 	
 	// Header
-	is << "{Algorithm} & {Binary Image} & {Label Image} & {Equivalence Vector/s}  & {Other} & {Total Accesses}";
+	is << "{Algorithm} & {Binary Image} & {Label Image} & {Equivalence Vector/s}  & {Other} & {Total " << char(toupper(kind[0])) << kind.substr(1) << "}";
 	is << "\\\\" << endl;
 	is << "\t\\hline" << endl;
 
@@ -1200,19 +2109,25 @@ void generateMemoryLatexTable(const string& output_path, const string& latex_fil
 		eraseDoubleEscape(algName);
 		is << "\t{" << algName << "}";
 
-		double tot = 0; 
+		double tot = 0, tot_variance = 0; 
 
 		for (int s = 0; s < accesses.cols; ++s){			
 			// For every data structure
-			if (accesses(i, s) != 0)
+			if (accesses(i, s) != 0){
 				is << "\t& " << (accesses(i, s) / 1000000);
+				if (sampling > 1)
+					is << " +- " << (errors(i, s) / 1000000);
+			}
 			else
 				is << "\t& "; 
 
 			tot += (accesses(i, s) / 1000000); 
+			tot_variance += (errors(i, s) / 1000000) * (errors(i, s) / 1000000);
 		}
 		// Total Accesses
 		is << "\t& " << tot; 
+		if (sampling > 1)
+			is << " +- " << sqrt(tot_variance);
 
 		// EndLine
 		is << "\t\\\\" << endl;
@@ -1226,6 +2141,77 @@ void generateMemoryLatexTable(const string& output_path, const string& latex_fil
 	is.close();
 }
 
+// Generate a latex table of cache misses for every level of the simulated cache hierarchy
+void generateCacheLatexTable(const string& output_path, const string& latex_file, const Mat1d& hits, const Mat1d& misses, const string& dataset, const vector<pair<CCLMemPointer, string>>& CCLMemAlgorithms, const cacheModel& cache){
+
+	string latex_path = output_path + kPathSeparator + dataset + kPathSeparator + latex_file;
+	ofstream is(latex_path);
+	if (!is.is_open()){
+		cout << "Unable to open/create " + latex_path << endl;
+		return;
+	}
+
+	// fixed number of decimal values
+	is << fixed;
+	is << setprecision(3);
+
+	is << "%This table format needs the package 'siunitx', please uncomment and add the following line code in latex preamble if you want to add the table in your latex file" << endl;
+	is << "%\\usepackage{siunitx}" << endl << endl;
+
+	for (size_t l = 0; l < cache.levels(); ++l){
+		const cacheLevelConfig& config = cache.config(l);
+
+		is << "\\begin{table}[tbh]" << endl << endl;
+		is << "\t\\centering" << endl;
+		is << "\t\\caption{Analysis of " << config.name << " misses (" << config.size / 1024 << " KiB, " << config.ways << "-way, " << config.line << " B lines, LRU) required by connected components computation for '" << dataset << "' dataset. The numbers are given in thousands of misses, the miss rate in percentage}" << endl;
+		is << "\t\\label{tab:cache" << l << "}" << endl;
+		is << "\t\\begin{tabular}{|l|";
+		for (int i = 0; i < MD_SIZE + 2; ++i)
+			is << "S[table-format=4.3]|";
+		is << "}" << endl;
+		is << "\t\\hline" << endl;
+		is << "\t";
+
+		// Header
+		is << "{Algorithm} & {Binary Image} & {Label Image} & {Equivalence Vector/s}  & {Other} & {Total Misses} & {Miss Rate}";
+		is << "\\\\" << endl;
+		is << "\t\\hline" << endl;
+
+		for (uint i = 0; i < CCLMemAlgorithms.size(); ++i){
+
+			// For every algorithm
+			string algName = CCLMemAlgorithms[i].second;
+			eraseDoubleEscape(algName);
+			is << "\t{" << algName << "}";
+
+			double tot_misses = 0, tot_accesses = 0;
+			for (int s = 0; s < MD_SIZE; ++s){
+				// For every data structure
+				const double m = misses(i, l * MD_SIZE + s), h = hits(i, l * MD_SIZE + s);
+				if (m + h != 0)
+					is << "\t& " << (m / 1000);
+				else
+					is << "\t& ";
+				tot_misses += m;
+				tot_accesses += m + h;
+			}
+			// Total Misses and Miss Rate (with respect to the accesses which reach this level)
+			is << "\t& " << tot_misses / 1000;
+			is << "\t& " << (tot_accesses ? tot_misses * 100 / tot_accesses : 0);
+
+			// EndLine
+			is << "\t\\\\" << endl;
+		}
+
+		// EndTable
+		is << "\t\\hline" << endl;
+		is << "\t\\end{tabular}" << endl << endl;
+		is << "\\end{table}" << endl << endl;
+	}
+
+	is.close();
+}
+
 
 int main(int argc, char **argv) 
 {
@@ -1237,15 +2223,45 @@ int main(int argc, char **argv)
          output_colors_average_test = cfg.getValueOfKey<bool>("at_colorLabels", false),
          write_n_labels = cfg.getValueOfKey<bool>("write_n_labels", true),
          check_8connectivity = cfg.getValueOfKey<bool>("check_8connectivity", true),
+         check_volumes = cfg.getValueOfKey<bool>("check_volumes", true), /* Check the algorithms on volumes with synthetic volumes */
          ds_saveMiddleTests = cfg.getValueOfKey<bool>("ds_saveMiddleTests", false),
          at_saveMiddleTests = cfg.getValueOfKey<bool>("at_saveMiddleTests", false),
          ds_perform = cfg.getValueOfKey<bool>("ds_perform", true),
          at_perform = cfg.getValueOfKey<bool>("at_perform", true),
-		 mt_perform = cfg.getValueOfKey<bool>("mt_perform", true);
+		 mt_perform = cfg.getValueOfKey<bool>("mt_perform", true),
+		 ct_perform = cfg.getValueOfKey<bool>("ct_perform", false),
+		 sy_perform = cfg.getValueOfKey<bool>("sy_perform", false),
+		 pt_perform = cfg.getValueOfKey<bool>("pt_perform", false),
+		 output_json = cfg.getValueOfKey<bool>("output_json", true),
+		 output_csv = cfg.getValueOfKey<bool>("output_csv", true),
+		 hs_perform = cfg.getValueOfKey<bool>("hs_perform", false),
+		 mt_cache = cfg.getValueOfKey<bool>("mt_cache", false),
+		 mt_trace = cfg.getValueOfKey<bool>("mt_trace", false),
+		 mt_heatmaps = cfg.getValueOfKey<bool>("mt_heatmaps", false), /* Save heatmaps and row totals of reads and writes of every matrix */
+		 tr_perform = cfg.getValueOfKey<bool>("tr_perform", false);
+
+	// Memory tests count one access every 'mt_sampling' on average, with counters of single elements, memory lines or rows ('mt_granularity')
+	unsigned mt_sampling = cfg.getValueOfKey<unsigned>("mt_sampling", 1);
+	string mt_granularity = cfg.getValueOfKey<string>("mt_granularity", "elements");
+
+	// Images processed in parallel by memory tests and by the correctness check (0 for one for every hardware thread). 
+	// Memory test results do not depend on the number of workers: every worker has its own cache model and memory 
+	// context (sampling is reseeded for every image and algorithm), traces are written per image and results are 
+	// summed in file order.
+	unsigned mt_threads = cfg.getValueOfKey<unsigned>("mt_threads", 0),
+	         ck_threads = cfg.getValueOfKey<unsigned>("ck_threads", 0);
+
+	// Threads which save color labels and middle results in background during the averages and density/size tests
+	unsigned output_threads = cfg.getValueOfKey<unsigned>("output_threads", 1);
 
     // Number of tests
     uint8_t ds_testsNumber = cfg.getValueOfKey<uint>("ds_testsNumber", 1), 
-            at_testsNumber = cfg.getValueOfKey<uint>("at_testsNumber", 1);
+            at_testsNumber = cfg.getValueOfKey<uint>("at_testsNumber", 1),
+            sy_testsNumber = cfg.getValueOfKey<uint>("sy_testsNumber", 1),
+            pt_testsNumber = cfg.getValueOfKey<uint>("pt_testsNumber", 3);
+
+    // Seed of the synthetic images generator (the same seed always generates the same images)
+    unsigned long long sy_seed = cfg.getValueOfKey<unsigned long long>("sy_seed", 0);
 
 	string input_txt = "files.txt",             /* Files who contains list of images's name on which CCLAlgorithms are tested */
            gnuplot_scipt_extension = ".gnuplot",  /* Extension of gnuplot scripts*/
@@ -1253,12 +2269,62 @@ int main(int argc, char **argv)
            middel_folder = "middle_results",
            latec_file = "averageResults.tex",
 		   latex_memory_file = "memoryAccesses.tex",
+		   latex_writes_file = "memoryWrites.tex",
+		   latex_cache_file = "cacheMisses.tex",
+		   json_file = "results.json",
+		   csv_file = "results.csv",
+		   history_file = "history.tsv",
+		   regressions_file = "regressions.txt",
+		   hs_baseline = cfg.getValueOfKey<string>("hs_baseline", ""), /* Revision to compare with (its last run on this host), the previous run on this host if empty */
            output_path = cfg.getValueOfKey<string>("output_path", "output"), /* Folder on which result are stored */
            input_path = cfg.getValueOfKey<string>("input_path", "input");    /* Folder on which datasets are placed */
                
     // List of dataset on which CCLA are checked
 	vector<string> check_list = cfg.getStringValuesOfKey("check_list", vector<string> {"3dpes", "fingerprints", "hamlet", "medical", "mirflickr", "test_random", "tobacco800"});
 
+	// Textures, sizes (side of square images) and densities of synthetic images
+	vector<string> sy_textures = cfg.getStringValuesOfKey("sy_textures", textureNames(false)),
+				   sy_sizes_str = cfg.getStringValuesOfKey("sy_sizes", vector<string> {"32", "64", "128", "256", "512", "1024", "2048", "4096", "8192", "16384", "32768"}),
+				   sy_densities_str = cfg.getStringValuesOfKey("sy_densities", vector<string> {"0.1", "0.2", "0.3", "0.4", "0.5", "0.6", "0.7", "0.8", "0.9"});
+	vector<int> sy_sizes; 
+	vector<double> sy_densities;
+	for (size_t s = 0; s < sy_sizes_str.size(); ++s)
+		sy_sizes.push_back(stoi(sy_sizes_str[s]));
+	for (size_t d = 0; d < sy_densities_str.size(); ++d)
+		sy_densities.push_back(stod(sy_densities_str[d]));
+
+	// Adversarial textures and sizes of pathological tests, and the tolerated excess of the growth exponent over 1
+	vector<string> pt_textures = cfg.getStringValuesOfKey("pt_textures", textureNames(true)),
+				   pt_sizes_str = cfg.getStringValuesOfKey("pt_sizes", vector<string> {"256", "512", "1024", "2048", "4096", "8192", "16384"});
+	vector<int> pt_sizes;
+	for (size_t s = 0; s < pt_sizes_str.size(); ++s)
+		pt_sizes.push_back(stoi(pt_sizes_str[s]));
+	double pt_tolerance = cfg.getValueOfKey<double>("pt_tolerance", 0.15);
+
+	// Tolerated relative slowdown with respect to the baseline run before a significant one is reported as a regression
+	double hs_tolerance = cfg.getValueOfKey<double>("hs_tolerance", 0.02);
+
+	// List of dataset on which engines' internal counters are collected
+	vector<string> counters_list = cfg.getStringValuesOfKey("counters_tests", vector<string> {"3dpes", "fingerprints", "hamlet", "medical", "mirflickr", "test_random", "tobacco800"});
+
+	// Simulated cache hierarchy of memory tests (a level with size 0 is skipped)
+	unsigned cache_line = cfg.getValueOfKey<unsigned>("cache_line", 64);
+	vector<cacheLevelConfig> cache_levels;
+	const cacheLevelConfig cache_default_levels[] = {
+		{ "L1", cfg.getValueOfKey<size_t>("cache_l1_size", 32768), cfg.getValueOfKey<unsigned>("cache_l1_ways", 8), cache_line },
+		{ "L2", cfg.getValueOfKey<size_t>("cache_l2_size", 262144), cfg.getValueOfKey<unsigned>("cache_l2_ways", 4), cache_line },
+		{ "LLC", cfg.getValueOfKey<size_t>("cache_llc_size", 8388608), cfg.getValueOfKey<unsigned>("cache_llc_ways", 16), cache_line },
+	};
+	for (size_t l = 0; l < sizeof(cache_default_levels) / sizeof(cache_default_levels[0]); ++l){
+		if (cache_default_levels[l].size > 0 && cache_default_levels[l].ways > 0)
+			cache_levels.push_back(cache_default_levels[l]);
+	}
+	cacheModel cache(cache_levels, MD_SIZE);
+
+	// Traces (paths relative to the output folder) to replay into reuse distance histograms, with blocks of 'tr_block_size' bytes (0 for single elements)
+	vector<string> tr_traces = cfg.getStringValuesOfKey("tr_traces", vector<string> {});
+	unsigned tr_block_size = cfg.getValueOfKey<unsigned>("tr_block_size", 64);
+
 	// List of dataset on which CCLA are memory checked
 	vector<string> memory_list = cfg.getStringValuesOfKey("memory_tests", vector<string> {"3dpes", "fingerprints", "hamlet", "medical", "mirflickr", "test_random", "tobacco800"});
 
@@ -1277,6 +2343,42 @@ int main(int argc, char **argv)
         return 1; 
     }
 
+    // Run length encoded output, converted to a dense image (timings include the conversion)
+    CCLAlgorithmsMap.insert({ "BBDT_OPT_RLE_DENSE", BBDT_OPT_RLE_DENSE });
+
+    // Run based labeling, on the runs of the binary image
+    CCLAlgorithmsMap.insert({ "RBTS_OPT", RBTS_OPT });
+
+    // BBDT_OPT and CTB_OPT with every union-find strategy, to compare them on the same scans
+    CCLAlgorithmsMap.insert({ "BBDT_OPT_UF_SUZUKI", BBDT_OPT_UF<ufSuzuki> });
+    CCLAlgorithmsMap.insert({ "BBDT_OPT_UF_HALVING", BBDT_OPT_UF<ufHalving> });
+    CCLAlgorithmsMap.insert({ "BBDT_OPT_UF_SPLITTING", BBDT_OPT_UF<ufSplitting> });
+    CCLAlgorithmsMap.insert({ "BBDT_OPT_UF_RANK", BBDT_OPT_UF<ufRank> });
+    CCLAlgorithmsMap.insert({ "BBDT_OPT_UF_SIZE", BBDT_OPT_UF<ufSize> });
+    CCLAlgorithmsMap.insert({ "BBDT_OPT_UF_REM", BBDT_OPT_UF<ufRem> });
+    CCLAlgorithmsMap.insert({ "BBDT_OPT_UF_LISTS", BBDT_OPT_UF<ufLists> });
+    CCLAlgorithmsMap.insert({ "CTB_OPT_UF_SUZUKI", CTB_OPT_UF<ufSuzuki> });
+    CCLAlgorithmsMap.insert({ "CTB_OPT_UF_HALVING", CTB_OPT_UF<ufHalving> });
+    CCLAlgorithmsMap.insert({ "CTB_OPT_UF_SPLITTING", CTB_OPT_UF<ufSplitting> });
+    CCLAlgorithmsMap.insert({ "CTB_OPT_UF_RANK", CTB_OPT_UF<ufRank> });
+    CCLAlgorithmsMap.insert({ "CTB_OPT_UF_SIZE", CTB_OPT_UF<ufSize> });
+    CCLAlgorithmsMap.insert({ "CTB_OPT_UF_REM", CTB_OPT_UF<ufRem> });
+    CCLAlgorithmsMap.insert({ "CTB_OPT_UF_LISTS", CTB_OPT_UF<ufLists> });
+
+    // Variants of BBDT_OPT and CTB_OPT with other outputs, through wrappers which output labels (see their headers)
+    CCLAlgorithmsMap.insert({ "BBDT_OPT_AREA_ALL", BBDT_OPT_AREA_ALL });
+    CCLAlgorithmsMap.insert({ "CTB_OPT_AREA_ALL", CTB_OPT_AREA_ALL });
+    CCLAlgorithmsMap.insert({ "BBDT_OPT_BOXES_CHECK", BBDT_OPT_BOXES_CHECK });
+    CCLAlgorithmsMap.insert({ "CTB_OPT_BOXES_CHECK", CTB_OPT_BOXES_CHECK });
+    CCLAlgorithmsMap.insert({ "BBDT_OPT_THR_BINARY", BBDT_OPT_THR_BINARY });
+    CCLAlgorithmsMap.insert({ "CTB_OPT_THR_BINARY", CTB_OPT_THR_BINARY });
+    CCLAlgorithmsMap.insert({ "BBDT_OPT_CONTOURS_CHECK", BBDT_OPT_CONTOURS_CHECK });
+
+    // Algorithms on volumes, class maps and greyscale images, through wrappers which label binary images
+    CCLAlgorithmsMap.insert({ "BBDT_3D_SLICE", BBDT_3D_SLICE });
+    CCLAlgorithmsMap.insert({ "LABEL_VALUES_BINARY", LABEL_VALUES_BINARY });
+    CCLAlgorithmsMap.insert({ "MAX_TREE_BINARY", MAX_TREE_BINARY });
+
     uint i = 0; 
     for (vector<string>::iterator it = funcName.begin(); it != funcName.end(); ++it, ++i){  
         if (CCLAlgorithmsMap.find(*it) == CCLAlgorithmsMap.end())
@@ -1297,6 +2399,10 @@ int main(int argc, char **argv)
 		return 1;
 	}
 
+	// Memory versions of the engines instantiated on the counting data structures
+	CCLMemAlgorithmsMap.insert({ "CTB_MEM", CTB_MEM });
+	CCLMemAlgorithmsMap.insert({ "CCIT_MEM", CCIT_MEM });
+
 	i = 0;
 	for (vector<string>::iterator it = funcMemName.begin(); it != funcMemName.end(); ++it, ++i){
 		if (CCLMemAlgorithmsMap.find(*it) == CCLMemAlgorithmsMap.end())
@@ -1310,6 +2416,13 @@ int main(int argc, char **argv)
    if(!makeDir(output_path))
 	   return 1;
 
+	// Results of the run exported in machine readable format
+	benchmarkResults results;
+	for (size_t a = 0; a < CCLAlgorithms.size(); ++a)
+		results.algorithms.push_back(CCLAlgorithms[a].second);
+	for (size_t a = 0; a < CCLMemAlgorithms.size(); ++a)
+		results.memAlgorithms.push_back(CCLMemAlgorithms[a].second);
+
 	// Check if algorithms are correct
     //if (check_8connectivity){
    if (true) {
@@ -1318,11 +2431,18 @@ int main(int argc, char **argv)
 			cout << "ERROR: no algorithms, check skipped" << endl; 
 		}
 		else{
-			checkAlgorithms(CCLAlgorithms, check_list, input_path, input_txt);
+			checkAlgorithms(CCLAlgorithms, check_list, input_path, input_txt, output_path, ck_threads);
 		}
+    }
+    if (check_volumes){
+        cout << "CHECK ALGORITHMS ON VOLUMES: " << endl;
+        check3DAlgorithms();
     }
 	// Check if algorithms are correct
 
+	// Color labels and middle results of the averages and density/size tests are saved in background
+	asyncWriter writer(output_threads);
+
 	// Test Algorithms with different input type and different output format, and show execution result
 	// AVERAGES TEST
     Mat1d all_res(input_folders_averages_test.size(), CCLAlgorithms.size(), numeric_limits<double>::max()); // We need it to save average results and generate latex table
@@ -1334,7 +2454,10 @@ int main(int argc, char **argv)
 		else{
 			for (unsigned int i = 0; i < input_folders_averages_test.size(); ++i){
 	    		cout << "Averages_Test on '" << input_folders_averages_test[i] << "': starts" << endl;
-				cout << averages_test(CCLAlgorithms, all_res, i, input_path, input_folders_averages_test[i], input_txt, gnuplot_scipt_extension, output_path, colors_folder, at_saveMiddleTests, at_testsNumber, middel_folder, write_n_labels, output_colors_average_test) << endl;
+				datasetTimings timings;
+				cout << averages_test(CCLAlgorithms, all_res, i, input_path, input_folders_averages_test[i], input_txt, gnuplot_scipt_extension, output_path, colors_folder, at_saveMiddleTests, at_testsNumber, middel_folder, timings, writer, write_n_labels, output_colors_average_test) << endl;
+				if (!timings.files.empty())
+					results.timings.push_back(timings);
 	    		cout << "Averages_Test on '" << input_folders_averages_test[i] << "': ends" << endl << endl;
 			}
         generateLatexTable(output_path, latec_file, all_res, input_folders_averages_test, CCLAlgorithms);
@@ -1350,16 +2473,68 @@ int main(int argc, char **argv)
 		else{
 			for (unsigned int i = 0; i < input_folders_density_size_test.size(); ++i){
 				cout << "Density_Size_Test on '" << input_folders_density_size_test[i] << "': starts" << endl;
-				cout << density_size_test(CCLAlgorithms, input_path, input_folders_density_size_test[i], input_txt, gnuplot_scipt_extension, output_path, colors_folder, ds_saveMiddleTests, ds_testsNumber, middel_folder, write_n_labels, output_colors_density_size) << endl;
+				cout << density_size_test(CCLAlgorithms, input_path, input_folders_density_size_test[i], input_txt, gnuplot_scipt_extension, output_path, colors_folder, ds_saveMiddleTests, ds_testsNumber, middel_folder, writer, write_n_labels, output_colors_density_size) << endl;
 				cout << "Density_Size_Test on '" << input_folders_density_size_test[i] << "': ends" << endl << endl;
 			}
 		}
     }
 
+	// SYNTHETIC_TESTS
+	if (sy_perform){
+		cout << endl << "SYNTHETIC TESTS: " << endl;
+		if (CCLAlgorithms.size() == 0){
+			cout << "ERROR: no algorithms, synthetic tests skipped" << endl;
+		}
+		else{
+			cout << "Synthetic_Test: starts" << endl;
+			cout << synthetic_test(CCLAlgorithms, sy_textures, sy_sizes, sy_densities, sy_seed, gnuplot_scipt_extension, output_path, sy_testsNumber) << endl;
+			cout << "Synthetic_Test: ends" << endl << endl;
+		}
+	}
+
+	// PATHOLOGICAL_TESTS
+	if (pt_perform){
+		cout << endl << "PATHOLOGICAL TESTS: " << endl;
+		if (CCLAlgorithms.size() == 0 || pt_sizes.size() < 2){
+			cout << "ERROR: no algorithms or less than two sizes, pathological tests skipped" << endl;
+		}
+		else{
+			cout << "Pathological_Test: starts" << endl;
+			cout << pathological_test(CCLAlgorithms, pt_textures, pt_sizes, pt_tolerance, gnuplot_scipt_extension, output_path, pt_testsNumber) << endl;
+			cout << "Pathological_Test: ends" << endl << endl;
+		}
+	}
+
+	// COUNTERS_TESTS
+	if (ct_perform){
+		cout << endl << "COUNTERS TESTS: " << endl;
+#ifndef CCL_COUNTERS
+		cout << "ERROR: engines' counters are not compiled in (define CCL_COUNTERS), counters tests skipped" << endl;
+#else
+		if (CCLAlgorithms.size() == 0){
+			cout << "ERROR: no algorithms, counters tests skipped" << endl;
+		}
+		else{
+			for (unsigned int i = 0; i < counters_list.size(); ++i){
+				cout << "Counters_Test on '" << counters_list[i] << "': starts" << endl;
+				cout << counters_test(CCLAlgorithms, input_path, counters_list[i], input_txt, output_path) << endl;
+				cout << "Counters_Test on '" << counters_list[i] << "': ends" << endl << endl;
+			}
+		}
+#endif
+	}
+
 	// MEMORY_TESTS
 	//if (mt_perform){
 	if (true) {
-		Mat1d accesses; 
+		Mat1d accesses, errors, writes, writes_errors, cache_hits, cache_misses; 
+		memoryTestOptions options = { mt_cache && cache.levels() ? &cache : nullptr, mt_trace, MG_ELEMENTS, max(mt_sampling, 1u), mt_threads, mt_heatmaps };
+		if (mt_granularity == "lines")
+			options.granularity = MG_LINES;
+		else if (mt_granularity == "rows")
+			options.granularity = MG_ROWS;
+		else if (mt_granularity != "elements")
+			cout << "Unknown memory accesses granularity '" + mt_granularity + "', 'elements' used" << endl;
 		cout << endl << "MEMORY TESTS: " << endl;
 		if (CCLMemAlgorithms.size() == 0){
 			cout << "ERROR: no algorithms, memory tests skipped" << endl;
@@ -1367,11 +2542,90 @@ int main(int argc, char **argv)
 		else{
 			for (unsigned int i = 0; i < memory_list.size(); ++i){
 				cout << "Memory_Test on '" << memory_list[i] << "': starts" << endl;
-				cout << memory_test(CCLMemAlgorithms, accesses, input_path, memory_list[i], input_txt, output_path) << endl;
+				cout << memory_test(CCLMemAlgorithms, accesses, errors, writes, writes_errors, input_path, memory_list[i], input_txt, output_path, options, cache_hits, cache_misses) << endl;
 				cout << "Memory_Test on '" << memory_list[i] << "': ends" << endl << endl;
-				generateMemoryLatexTable(output_path, latex_memory_file, accesses, memory_list[i], CCLMemAlgorithms);
+				generateMemoryLatexTable(output_path, latex_memory_file, accesses, errors, options.sampling, memory_list[i], CCLMemAlgorithms);
+				generateMemoryLatexTable(output_path, latex_writes_file, writes, writes_errors, options.sampling, memory_list[i], CCLMemAlgorithms, "writes");
+				if (mt_cache && cache.levels())
+					generateCacheLatexTable(output_path, latex_cache_file, cache_hits, cache_misses, memory_list[i], CCLMemAlgorithms, cache);
+				results.accesses.push_back({ memory_list[i], accesses.clone() });
+			}
+		}
+	}
+
+	// TRACE ANALYSIS
+	if (tr_perform){
+		cout << endl << "TRACE ANALYSIS: " << endl;
+		for (size_t i = 0; i < tr_traces.size(); ++i){
+			string trace_path = output_path + kPathSeparator + tr_traces[i];
+			vector<reuseHistogram> histograms;
+			vector<traceStructure> structures;
+			if (!reuseDistances(trace_path, tr_block_size, histograms, structures)){
+				cout << "Trace_Analysis on '" + tr_traces[i] + "': Unable to read " + trace_path << endl;
+				continue;
+			}
+			if (!writeReuseHistograms(trace_path + ".reuse.txt", histograms, structures)){
+				cout << "Trace_Analysis on '" + tr_traces[i] + "': Unable to open/create " + trace_path + ".reuse.txt" << endl;
+				continue;
+			}
+			cout << "Trace_Analysis on '" + tr_traces[i] + "': successfuly done" << endl;
+		}
+	}
+
+	// MACHINE READABLE RESULTS
+	hostInfo host = getHostInfo();
+	if (output_json && !writeJsonResults(output_path + kPathSeparator + json_file, host, results))
+		cout << "Unable to open/create " + output_path + kPathSeparator + json_file << endl;
+	if (output_csv && !writeCsvResults(output_path + kPathSeparator + csv_file, host, results))
+		cout << "Unable to open/create " + output_path + kPathSeparator + csv_file << endl;
+
+	// BENCHMARK HISTORY
+	if (hs_perform){
+		string history_path = output_path + kPathSeparator + history_file,
+			   revision = getGitRevision();
+		const bool dirty = getGitDirty();
+		vector<historyEntry> history = loadHistory(history_path);
+
+		historyEntry baseline_run;
+		if (!previousRun(history, host.hostname, hs_baseline, baseline_run)){
+			cout << "Benchmark history: no previous run" + (hs_baseline.empty() ? "" : " of '" + hs_baseline + "'") + " on '" + host.hostname + "', nothing to compare with" << endl;
+		}
+		else{
+			const string baseline = runName(baseline_run);
+			vector<regressionCheck> checks = checkRegressions(history, baseline_run, results, hs_tolerance);
+			ofstream os(output_path + kPathSeparator + regressions_file);
+			if (!os.is_open())
+				cout << "Unable to open/create " + output_path + kPathSeparator + regressions_file << endl;
+			else{
+				os << "#Comparison of revision " << revision << (dirty ? "-dirty" : "") << " (" << host.compiler << ", " << host.date << ") with baseline " << baseline << " on " << host.hostname << endl;
+				os << "#Dataset\tAlgorithm\tBaseline(ms)\tCurrent(ms)\tSlowdown(%)\tWelch_t\tSignificant\tRegression" << endl;
+				os << fixed << setprecision(3);
+				unsigned regressions = 0, skipped = 0;
+				for (size_t c = 0; c < checks.size(); ++c){
+					os << checks[c].dataset << "\t" << checks[c].algorithm << "\t" << checks[c].baseline_mean << "\t" << checks[c].current_mean << "\t"
+					   << checks[c].slowdown * 100 << "\t" << checks[c].t << "\t" << (!checks[c].enough_samples ? "skipped" : checks[c].significant ? "yes" : "no") << "\t" << (checks[c].regression ? "yes" : "no") << endl;
+					if (!checks[c].enough_samples)
+						skipped++;
+					if (checks[c].regression){
+						cout << "Regression: '" + checks[c].algorithm + "' on '" + checks[c].dataset + "' is " << setprecision(1) << fixed << checks[c].slowdown * 100 << "% slower than at " + baseline << endl;
+						regressions++;
+					}
+				}
+				if (checks.empty())
+					cout << "Benchmark history: baseline '" + baseline + "' has no results in common with the current run" << endl;
+				else if (skipped == checks.size())
+					cout << "Benchmark history: not enough samples, regression check skipped (at least 2 per side are needed, set at_testsNumber >= 2)" << endl;
+				else{
+					cout << "Benchmark history: " << regressions << " regression(s) with respect to '" + baseline + "'";
+					if (skipped)
+						cout << ", " << skipped << " of " << checks.size() << " check(s) skipped for not enough samples";
+					cout << endl;
+				}
 			}
 		}
+
+		if (!appendHistory(history_path, revision, dirty, host, results))
+			cout << "Unable to open/create " + history_path << endl;
 	}
 
 	return 0; 
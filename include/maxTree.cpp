@@ -0,0 +1,112 @@
+// Copyright(c) 2016 - Costantino Grana, Federico Bolelli, Lorenzo Baraldi and Roberto Vezzani
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// *Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+// 
+// * Neither the name of YACCLAB nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "maxTree.h"
+#include "equivalenceSolverSuzuki.h"
+
+using namespace cv;
+using namespace std;
+
+void maxTree::build(const Mat1b &img) {
+	rows = img.rows;
+	cols = img.cols;
+	const uint n = (uint)rows * cols;
+
+	// Counting sort of the pixels by level
+	level_begin.assign(257, 0);
+	for (int r = 0; r < rows; ++r) {
+		const uchar * const img_row = img.ptr<uchar>(r);
+		for (int c = 0; c < cols; ++c)
+			level_begin[img_row[c] + 1]++;
+	}
+	for (int v = 0; v < 256; ++v)
+		level_begin[v + 1] += level_begin[v];
+
+	pixels.resize(n);
+	levels.resize(n);
+	vector<uint> node(n);	// Node of every pixel
+	vector<uint> next(level_begin.begin(), level_begin.end() - 1);
+	for (int r = 0; r < rows; ++r) {
+		const uchar * const img_row = img.ptr<uchar>(r);
+		for (int c = 0; c < cols; ++c) {
+			const uint i = next[img_row[c]]++;
+			pixels[i] = (uint)r * cols + c;
+			levels[i] = img_row[c];
+			node[pixels[i]] = i;
+		}
+	}
+
+	// Nodes are added from the highest level: the new node becomes the parent of the roots of the neighbors 
+	// already added. Roots of the union-find (zpar) are the nodes with the smallest index, as parents.
+	parent.resize(n);
+	vector<uint> zpar(n);
+	for (uint i = n; i-- > 0;) {
+		parent[i] = i;
+		zpar[i] = i;
+		const int r = pixels[i] / cols, c = pixels[i] % cols;
+		for (int nr = max(r - 1, 0); nr <= min(r + 1, rows - 1); ++nr) {
+			for (int nc = max(c - 1, 0); nc <= min(c + 1, cols - 1); ++nc) {
+				const uint j = node[(uint)nr * cols + nc];
+				if (j <= i)
+					continue;
+				const uint root = find(zpar.data(), j);
+				if (root != i) {
+					parent[root] = i;
+					zpar[root] = i;
+				}
+			}
+		}
+	}
+
+	// Canonicalization: parents are visited before their children
+	for (uint i = 1; i < n; ++i) {
+		const uint q = parent[i];
+		if (levels[parent[q]] == levels[q])
+			parent[i] = parent[q];
+	}
+}
+
+int maxTree::labels(uchar thresh, Mat1i &imgLabels) const {
+	imgLabels = Mat1i(rows, cols, 0);
+	uint * const labels = (uint *)imgLabels.data;	// Continuous, since it has just been allocated
+
+	// Nodes above the threshold are the last ones, and their parents come first: a node starts a new component if 
+	// its parent is below the threshold (or it is the root), otherwise it has the label of its parent.
+	uint lunique = 1;
+	for (uint i = level_begin[thresh]; i < pixels.size(); ++i) {
+		const uint q = parent[i];
+		labels[pixels[i]] = (q == i || levels[q] < thresh) ? lunique++ : labels[pixels[q]];
+	}
+	return lunique;
+}
+
+int MAX_TREE_BINARY(const Mat1b &img, Mat1i &imgLabels) {
+	maxTree tree;
+	tree.build(img);
+	return tree.labels(1, imgLabels);
+}
@@ -0,0 +1,60 @@
+// Copyright(c) 2016 - Costantino Grana, Federico Bolelli, Lorenzo Baraldi and Roberto Vezzani
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// *Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+// 
+// * Neither the name of YACCLAB nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include "opencv2/opencv.hpp"
+#include <vector>
+
+// Max-tree (component tree) of a greyscale image with 8-connectivity, built with Berger's union-find algorithm: 
+// the connected components of the images thresholded at every grey level are the nodes of a single tree, so the 
+// labels at any threshold are extracted without labeling the image again (e.g. to find blobs which are stable 
+// over a range of thresholds).
+// Nodes are the pixels, indexed by their position in 'pixels', where they are sorted by increasing level (ties in 
+// row major order). Every node has a smaller index than its children, so the union-find of 
+// equivalenceSolverSuzuki.h is used unchanged, and the root is node 0. The canonical node of a component is the 
+// first one of its level, and parent[i] is the canonical node of the smallest component strictly containing i at 
+// its level (the root is its own parent).
+struct maxTree{
+	int rows = 0;
+	int cols = 0;
+	std::vector<uint> pixels;		// Row major index of the pixel of every node
+	std::vector<uint> parent;
+	std::vector<uchar> levels;		// Grey level of every node
+	std::vector<uint> level_begin;	// First node of every level (257 elements)
+
+	void build(const cv::Mat1b &img);
+
+	// Labels of the components of the pixels with value greater than or equal to 'thresh', consecutive starting 
+	// from 1. Only the nodes above the threshold are visited, besides clearing the output. Returns the number of 
+	// labels + 1, as the labeling algorithms.
+	int labels(uchar thresh, cv::Mat1i &imgLabels) const;
+};
+
+// Labels of the foreground of a binary image (values greater than 0) extracted from its max-tree, to check the 
+// max-tree with the labeling algorithms
+int MAX_TREE_BINARY(const cv::Mat1b &img, cv::Mat1i &imgLabels);
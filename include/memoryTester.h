@@ -28,6 +28,10 @@
 
 #pragma once 
 #include "opencv2/opencv.hpp"
+#include <cmath>
+#include <algorithm>
+#include "cacheSimulator.h"
+#include "memoryTrace.h"
 
 enum memorydatatype{
 
@@ -43,6 +47,290 @@ enum memorydatatype{
 	MD_SIZE = 4, 
 };
 
+// Granularity of the access counters of memMat and memVector
+enum memgranularity{
+	MG_ELEMENTS = 0,	// One counter for every element (for every block of adjacent elements with sampling, see memContext)
+	MG_LINES = 1,		// One counter for every memory line of MEM_LINE_SIZE bytes (for every block of lines with sampling)
+	MG_ROWS = 2,		// One counter for every row (memory lines for memVector)
+};
+
+#define MEM_LINE_SIZE 64
+
+// Accesses to a data structure, reported to the collector of the memory context when the structure is destroyed
+struct memAccessesReport{
+	memorydatatype type;
+	memgranularity granularity;
+	int rows, cols;								// Size of matrices, 0 x 0 for vectors
+	int counters_cols;							// Counters of every row of matrices at MG_ELEMENTS granularity
+	double reads, writes;
+	std::vector<double> reads_counts, writes_counts;	// Counters at the granularity of the structure (only if details are requested)
+};
+
+struct memCollector{
+	bool details = false;						// Collect the counters, besides the totals
+	std::vector<memAccessesReport> reports;		// In order of destruction
+};
+
+// Memory context of the current thread. While a cache model is active, memMat and memVector created 
+// by the thread get a simulated address range and feed the model with the address of every access. 
+// Simulated addresses are page aligned and assigned in order of creation, so results do not depend 
+// on the allocator nor on the hardware. While a trace writer is active, they are defined in the trace 
+// and every access is recorded.
+// 
+// Granularity and sampling set how data structures created from now on count accesses: with 
+// sampling N > 1 every access is counted with probability 1/N (skips between counted accesses are 
+// geometric, drawn by a per structure generator seeded from 'seed'), and totals are estimated 
+// multiplying by N. Sampled counters are widened so that each of them collects about as many accesses
+// as without sampling: at MG_ELEMENTS granularity a counter covers the largest power of 2 not greater 
+// than N adjacent elements of a row, and at MG_LINES granularity as many adjacent lines.
+// 
+// Counters at the chosen granularity count all the accesses, and reads and writes are told apart only 
+// by totals: with 'write_counters' data structures also keep counters of writes, to split every counter 
+// in reads and writes.
+// 
+// While a collector is active, the data structures destroyed by the thread report their accesses to it.
+struct memContext{
+	cacheModel *cache = nullptr;
+	traceWriter *trace = nullptr;
+	memCollector *collector = nullptr;
+	uint64_t next_address = 0;
+	memgranularity granularity = MG_ELEMENTS;
+	unsigned sampling = 1;
+	bool write_counters = false;
+	uint64_t seed = 0;
+	unsigned structures = 0;	// Number of structures created since the last reseed
+
+	// Set the cache model which will be fed by the data structures created from now on (nullptr to disable it)
+	void activate(cacheModel *model){
+		cache = model;
+		next_address = 0;
+	}
+
+	uint64_t allocate(size_t bytes){
+		uint64_t base = next_address;
+		next_address += (bytes + 4095) & ~uint64_t(4095);
+		return base;
+	}
+
+	// Make the samplers of the structures created from now on deterministic
+	void reseed(uint64_t new_seed){
+		seed = new_seed;
+		structures = 0;
+	}
+};
+
+inline memContext& memoryContext(){
+	static thread_local memContext context;
+	return context;
+}
+
+// Mark the beginning of a phase of the algorithm in the active trace (if any)
+inline void memoryPhase(const char *name){
+	if (memoryContext().trace)
+		memoryContext().trace->phase(name);
+}
+
+// Standard error of a number of accesses estimated with 1-in-'sampling' accounting. Every access is 
+// counted independently with probability p = 1/sampling, so the variance of the estimate is n(1-p)/p.
+// Errors of independent estimates (e.g. of different images) add in quadrature.
+inline double sampledAccessesError(double estimated_accesses, unsigned sampling){
+	return std::sqrt(estimated_accesses * (sampling - 1));
+}
+
+// Accounting of the accesses to a data structure, shared by memMat and memVector: totals of reads and writes, 
+// counters at the granularity of the memory context, and forwarding of accesses to the active cache model and trace
+class memAccounting{
+public:
+	memAccounting() = default;
+	memAccounting(const memAccounting&) = delete;
+	memAccounting& operator=(const memAccounting&) = delete;
+
+	~memAccounting(){
+		if (!_collector)
+			return;
+		memAccessesReport report;
+		report.type = _type;
+		report.granularity = _granularity;
+		report.rows = _rows;
+		report.cols = _cols;
+		report.counters_cols = _counters_cols;
+		report.reads = total(TA_READ);
+		report.writes = total(TA_WRITE);
+		if (_collector->details){
+			report.reads_counts = counts(TA_READ);
+			report.writes_counts = counts(TA_WRITE);
+		}
+		_collector->reports.push_back(report);
+	}
+
+	void attach(memorydatatype type, size_t elements, unsigned element_size, int rows, int cols){
+		memContext& context = memoryContext();
+
+		_type = type;
+		_rows = rows;
+		_cols = cols;
+		_granularity = context.granularity;
+		if (_granularity == MG_ROWS && cols == 0)
+			_granularity = MG_LINES; // Vectors have no rows
+
+		_sampling = std::max(context.sampling, 1u);
+		_rng = (context.seed + ++context.structures) * 0x9E3779B97F4A7C15ull;
+		_log_keep = _sampling > 1 ? std::log(1 - 1. / _sampling) : 0;
+		_skip = nextSkip();
+
+		// Counters of elements and lines are widened by the sampling factor (rounded down to a power of 2)
+		_shift = 0;
+		if (_granularity == MG_LINES){
+			while (((size_t)element_size << (_shift + 1)) <= MEM_LINE_SIZE)
+				_shift++;
+		}
+		if (_granularity != MG_ROWS){
+			for (unsigned n = _sampling; n > 1; n >>= 1)
+				_shift++;
+		}
+		_counters_cols = _granularity == MG_ELEMENTS && cols ? ((cols - 1) >> _shift) + 1 : 0;
+		size_t counters = _granularity == MG_ROWS ? rows : (cols && _granularity == MG_ELEMENTS ? (size_t)rows * _counters_cols : (elements ? ((elements - 1) >> _shift) + 1 : 0));
+		_counts = std::vector<unsigned>(counters, 0);
+		_writes = std::vector<unsigned>(context.write_counters ? counters : 0, 0);
+		_totals[0] = _totals[1] = 0;
+
+		_cache = context.cache;
+		_base = _cache ? context.allocate(elements * element_size) : 0;
+		_element_size = element_size;
+		_trace = context.trace;
+		_trace_id = _trace ? _trace->addStructure(type, element_size, elements, cols) : 0;
+		_collector = context.collector;
+	}
+
+	// Access of kind 'kind' (TA_READ or TA_WRITE) to element 'index', in row 'row' for matrices. Without sampling 
+	// the skip is always 1, so only accesses which are counted pay for the counters.
+	void access(uint64_t index, int row, traceaccesskind kind){
+		if (--_skip == 0)
+			count(index, row, kind);
+		if (_cache)
+			_cache->access(_base + index * _element_size, _type);
+		if (_trace)
+			_trace->access(_trace_id, index, kind);
+	}
+
+	// Counters of reads or writes at the chosen granularity, scaled by the sampling factor. They are available 
+	// only if the data structure keeps counters of writes (see memContext), otherwise the vector is empty.
+	std::vector<double> counts(traceaccesskind kind) const{
+		std::vector<double> scaled(_writes.size());
+		for (size_t i = 0; i < _writes.size(); ++i)
+			scaled[i] = (double)(kind == TA_WRITE ? _writes[i] : _counts[i] - _writes[i]) * _sampling;
+		return scaled;
+	}
+
+	// Counters of all the accesses at the chosen granularity, scaled by the sampling factor
+	std::vector<double> counts() const{
+		std::vector<double> scaled(_counts.size());
+		for (size_t i = 0; i < _counts.size(); ++i)
+			scaled[i] = (double)_counts[i] * _sampling;
+		return scaled;
+	}
+
+	double total(traceaccesskind kind) const{
+		return (double)_totals[kind == TA_WRITE] * _sampling;
+	}
+
+	double total() const{
+		return total(TA_READ) + total(TA_WRITE);
+	}
+
+	double error() const{
+		return sampledAccessesError(total(), _sampling);
+	}
+
+	memgranularity granularity() const{
+		return _granularity;
+	}
+
+	// Counters of every row of matrices at MG_ELEMENTS granularity (cols without sampling)
+	int countersCols() const{
+		return _counters_cols;
+	}
+
+private:
+	memorydatatype _type;
+	memgranularity _granularity;
+	int _rows, _cols;
+	unsigned _shift;				// log2 of elements per counter (of a row for matrices at MG_ELEMENTS granularity)
+	int _counters_cols;
+	std::vector<unsigned> _counts;	// All the accesses
+	std::vector<unsigned> _writes;	// Writes, empty if not requested
+	uint64_t _totals[2];			// Reads and writes
+	unsigned _sampling;
+	uint64_t _rng;
+	double _log_keep;				// log(1 - 1/sampling)
+	uint64_t _skip;					// Accesses to the next counted one
+	cacheModel *_cache;
+	uint64_t _base;
+	unsigned _element_size;
+	traceWriter *_trace;
+	unsigned _trace_id;
+	memCollector *_collector = nullptr;
+
+	void count(uint64_t index, int row, traceaccesskind kind){
+		_skip = nextSkip();
+		size_t counter;
+		if (_granularity == MG_ROWS)
+			counter = row;
+		else if (_counters_cols)
+			counter = (size_t)row * _counters_cols + (size_t)((index - (uint64_t)row * _cols) >> _shift);
+		else
+			counter = (size_t)(index >> _shift);
+		_counts[counter]++;
+		if (kind == TA_WRITE){
+			_totals[1]++;
+			if (!_writes.empty())
+				_writes[counter]++;
+		}
+		else
+			_totals[0]++;
+	}
+
+	// Geometric number of accesses to the next counted one (xorshift64* generator)
+	uint64_t nextSkip(){
+		if (_sampling == 1)
+			return 1;
+		_rng ^= _rng >> 12;
+		_rng ^= _rng << 25;
+		_rng ^= _rng >> 27;
+		const double u = ((_rng * 0x2545F4914F6CDD1Dull) >> 11) * (1. / 9007199254740992.) + (1. / 18014398509481984.); // (0, 1)
+		return 1 + (uint64_t)(std::log(u) / _log_keep);
+	}
+};
+
+// Reference to an element of a memMat or memVector. Reading it (conversion to ViewT) is counted as a 
+// read and assigning it as a write. Assignments return the assigned value, not the reference, so that 
+// in a = b = c the value of b is not read again, as it would not be by the plain engines.
+template <typename ViewT>
+class memRef {
+public:
+	memRef(ViewT *element, memAccounting& accounting, uint64_t index, int row) : _element(element), _accounting(&accounting), _index(index), _row(row) {}
+
+	operator ViewT() const {
+		_accounting->access(_index, _row, TA_READ);
+		return *_element;
+	}
+
+	ViewT operator=(const ViewT value) {
+		_accounting->access(_index, _row, TA_WRITE);
+		*_element = value;
+		return value;
+	}
+
+	ViewT operator=(const memRef& other) {
+		return *this = (ViewT)other;
+	}
+
+private:
+	ViewT *_element;
+	memAccounting *_accounting;
+	uint64_t _index;
+	int _row;
+};
 
 template <typename T>
 class memMat {
@@ -51,89 +339,165 @@ public:
 	int rows; 
 	int cols; 
 
-	memMat(cv::Mat_<T> img){
+	memMat(cv::Mat_<T> img, memorydatatype type = MD_OTHER){
 		_img = img.clone(); // Deep copy
-		_accesses = cv::Mat1i(img.size(), 0); 
 		rows = img.rows; 
 		cols = img.cols; 
+		_accounting.attach(type, (size_t)rows * cols, sizeof(T), rows, cols);
 	}
 
-	memMat(cv::Size size){
+	memMat(cv::Size size, memorydatatype type = MD_OTHER){
 		_img = cv::Mat_<T>(size); 
-		_accesses = cv::Mat1i(size, 0);
 		rows = size.height; 
 		cols = size.width; 
+		_accounting.attach(type, (size_t)rows * cols, sizeof(T), rows, cols);
 	}
 
-	memMat(cv::Size size, const T val){
+	memMat(cv::Size size, const T val, memorydatatype type = MD_OTHER){
 		_img = cv::Mat_<T>(size, val);
-		_accesses = cv::Mat1i(size, 1);	// The initilization accesses must be counted
 		rows = size.height;
 		cols = size.width;
+		_accounting.attach(type, (size_t)rows * cols, sizeof(T), rows, cols);
+		// The initilization accesses must be counted
+		for (int r = 0; r < rows; ++r)
+			for (int c = 0; c < cols; ++c)
+				_accounting.access((uint64_t)r * cols + c, r, TA_WRITE);
+	}
+
+	memRef<T> operator()(const int r, const int c) {
+		return ref<T>(r, c);
 	}
 
-	T& operator()(const int r, const int c) {
-		_accesses.ptr<int>(r)[c]++; // Count access
-		return _img.template ptr<T>(r)[c];
+	// Reference to the element (r, c) seen as ViewT, which must have the same size of T
+	template <typename ViewT>
+	memRef<ViewT> ref(const int r, const int c) {
+		return memRef<ViewT>(reinterpret_cast<ViewT*>(_img.template ptr<T>(r) + c), _accounting, (uint64_t)r * cols + c, r);
 	}
 
 	cv::Mat_<T> getImage() const{
 		return _img.clone(); 
 	}
 
-	cv::Mat1i getAcessesMat() const{
-		return _accesses.clone(); 
+	// Accesses of every element (rows x cols), row (rows x 1) or memory line (1 x lines), depending on the granularity. 
+	// With sampling elements and lines are grouped in blocks (see memContext), so elements give rows x countersCols().
+	cv::Mat1d getAcessesMat() const{
+		return accessesMat(_accounting.counts(), _accounting.granularity(), rows, _accounting.countersCols());
+	}
+
+	// Reads (TA_READ) or writes (TA_WRITE) of every element, row or memory line, as getAcessesMat. Empty if the 
+	// matrix does not keep counters of writes (see memContext).
+	cv::Mat1d getAcessesMat(traceaccesskind kind) const{
+		return accessesMat(_accounting.counts(kind), _accounting.granularity(), rows, _accounting.countersCols());
+	}
+
+	// Counters of elements of every row (cols without sampling)
+	int countersCols() const{
+		return _accounting.countersCols();
+	}
+
+	// Shapes counters of a matrix as a Mat1d, as returned by getAcessesMat ('cols' are counters of every row)
+	static cv::Mat1d accessesMat(const std::vector<double>& counts, memgranularity granularity, int rows, int cols){
+		cv::Mat1d accesses;
+		if (counts.empty())
+			return accesses;
+		switch (granularity){
+		case MG_ELEMENTS: accesses = cv::Mat1d(rows, cols); break;
+		case MG_ROWS: accesses = cv::Mat1d(rows, 1); break;
+		default: accesses = cv::Mat1d(1, (int)counts.size()); break;
+		}
+		std::copy(counts.begin(), counts.end(), accesses.template ptr<double>(0));
+		return accesses;
 	}
 
 	double getTotalAcesses() const{
-		return cv::sum(_accesses)[0]; 
+		return _accounting.total(); 
+	}
+
+	double getTotalAcesses(traceaccesskind kind) const{
+		return _accounting.total(kind);
+	}
+
+	// Standard error of the total accesses (0 without sampling)
+	double getAccessesError() const{
+		return _accounting.error();
 	}
 
 	//~memMat();  // This is the destructor: declaration
 
 private:
 	cv::Mat_<T> _img;
-	cv::Mat1i _accesses;
+	memAccounting _accounting;
+};
+
+// Row of a memMat which behaves like a row pointer: elements are memRef, so every read and write is 
+// counted. Elements are seen as ViewT, which must have the same size of T.
+template <typename T, typename ViewT = T>
+class memRow {
+public:
+	memRow(memMat<T>& mat, int r) : _mat(&mat), _r(r) {}
+
+	memRef<ViewT> operator[](const int c) const {
+		return _mat->template ref<ViewT>(_r, c);
+	}
+
+private:
+	memMat<T> *_mat;
+	int _r;
 };
 
 template <typename T>
 class memVector {
 public:
-	memVector(std::vector<T> vec){
+	typedef T value_type;
+
+	memVector(std::vector<T> vec, memorydatatype type = MD_OTHER){
 		_vec = vec;  // Deep copy
-		_accesses = std::vector<int>(vec.size(), 0);
+		_accounting.attach(type, _vec.size(), sizeof(T), 0, 0);
 	}
 
-	memVector(const size_t size){
+	memVector(const size_t size, memorydatatype type = MD_OTHER){
 		_vec = std::vector<T>(size);
-		_accesses = std::vector<int>(size, 0);
+		_accounting.attach(type, _vec.size(), sizeof(T), 0, 0);
 	}
 
-	memVector(const size_t size, const T val){
+	memVector(const size_t size, const T val, memorydatatype type = MD_OTHER){
 		_vec = std::vector<T>(size, val);
-		_accesses = std::vector<int>(size, 1); // The initilization accesses must be counted
+		_accounting.attach(type, _vec.size(), sizeof(T), 0, 0);
+		// The initilization accesses must be counted
+		for (size_t i = 0; i < size; ++i)
+			_accounting.access(i, 0, TA_WRITE);
 	}
 
-	T& operator[](const int i){
-		_accesses[i]++; // Count access
-		return _vec[i];
+	memRef<T> operator[](const int i){
+		return memRef<T>(&_vec[i], _accounting, i, 0);
 	}
 
 	std::vector<T> getVector() const{
 		return _vec;
 	}
 
-	std::vector<T> getAcessesVector() const{
-		return _accesses;
+	// Accesses of every element or memory line, depending on the granularity
+	std::vector<double> getAcessesVector() const{
+		return _accounting.counts();
+	}
+
+	// Reads (TA_READ) or writes (TA_WRITE) of every element or memory line, empty if the vector does not keep 
+	// counters of writes (see memContext)
+	std::vector<double> getAcessesVector(traceaccesskind kind) const{
+		return _accounting.counts(kind);
 	}
 
 	double getTotalAcesses() const{
-		double tot = 0; 
-		for (size_t i = 0; i < _accesses.size(); ++i){
-			tot += _accesses[i]; 
-		}
+		return _accounting.total(); 
+	}
+
+	double getTotalAcesses(traceaccesskind kind) const{
+		return _accounting.total(kind);
+	}
 
-		return tot; 
+	// Standard error of the total accesses (0 without sampling)
+	double getAccessesError() const{
+		return _accounting.error();
 	}
 
 	T* getDataPointer(){
@@ -150,7 +514,7 @@ public:
 
 		for (size_t i = begin; i < end; ++i){
 			_vec[i] = _value++;
-			_accesses[i]++;	// increment access
+			_accounting.access(i, 0, TA_WRITE);	// increment access
 		}
 	}
 
@@ -158,7 +522,7 @@ public:
 
 private:
 	std::vector<T> _vec;
-	std::vector<int> _accesses;
+	memAccounting _accounting;
 };
 
 //template <typename T>
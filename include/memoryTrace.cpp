@@ -0,0 +1,349 @@
+// Copyright(c) 2016 - Costantino Grana, Federico Bolelli, Lorenzo Baraldi and Roberto Vezzani
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// *Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+// 
+// * Neither the name of YACCLAB nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "memoryTrace.h"
+
+#include <fstream>
+#include <map>
+#include <unordered_map>
+#include <algorithm>
+
+#include "memoryTester.h"
+
+using namespace std;
+
+bool traceWriter::open(const string& path){
+	close();
+	_file = fopen(path.c_str(), "wb");
+	if (!_file)
+		return false;
+	_buffer.reserve(BUFFER_SIZE);
+	_last.clear();
+	const uint8_t header[] = { 'Y', 'T', 'R', 'C', TRACE_VERSION };
+	fwrite(header, 1, sizeof(header), _file);
+	return true;
+}
+
+void traceWriter::flush(){
+	if (_file && !_buffer.empty())
+		fwrite(_buffer.data(), 1, _buffer.size(), _file);
+	_buffer.clear();
+}
+
+void traceWriter::close(){
+	if (!_file)
+		return;
+	flush();
+	fclose(_file);
+	_file = nullptr;
+}
+
+unsigned traceWriter::addStructure(unsigned type, unsigned element_size, uint64_t elements, uint64_t cols){
+	const unsigned id = (unsigned)_last.size();
+	_last.push_back(0);
+	put(TRACE_TAG_STRUCTURE);
+	putVarint(id);
+	putVarint(type);
+	putVarint(element_size);
+	putVarint(elements);
+	putVarint(cols);
+	return id;
+}
+
+void traceWriter::phase(const string& name){
+	put(TRACE_TAG_PHASE);
+	putVarint(name.size());
+	for (size_t i = 0; i < name.size(); ++i)
+		put((uint8_t)name[i]);
+}
+
+bool traceReader::open(const string& path){
+	close();
+	_file = fopen(path.c_str(), "rb");
+	if (!_file)
+		return false;
+	uint8_t header[5];
+	if (fread(header, 1, sizeof(header), _file) != sizeof(header) || header[0] != 'Y' || header[1] != 'T' || header[2] != 'R' || header[3] != 'C' || header[4] != TRACE_VERSION){
+		close();
+		return false;
+	}
+	return true;
+}
+
+void traceReader::close(){
+	if (_file)
+		fclose(_file);
+	_file = nullptr;
+	_buffer.clear();
+	_pos = 0;
+	_structures.clear();
+	_last.clear();
+}
+
+bool traceReader::get(uint8_t& byte){
+	if (_pos == _buffer.size()){
+		if (!_file)
+			return false;
+		_buffer.resize(1 << 20);
+		_buffer.resize(fread(_buffer.data(), 1, _buffer.size(), _file));
+		_pos = 0;
+		if (_buffer.empty())
+			return false;
+	}
+	byte = _buffer[_pos++];
+	return true;
+}
+
+bool traceReader::getVarint(uint64_t& value){
+	value = 0;
+	uint8_t byte;
+	for (unsigned shift = 0; shift < 64; shift += 7){
+		if (!get(byte))
+			return false;
+		value |= (uint64_t)(byte & 0x7F) << shift;
+		if (!(byte & 0x80))
+			return true;
+	}
+	return false;
+}
+
+bool traceReader::next(traceRecord& record){
+	uint8_t tag;
+	if (!get(tag))
+		return false;
+
+	if (tag == TRACE_TAG_PHASE){
+		uint64_t length;
+		if (!getVarint(length))
+			return false;
+		record.what = traceRecord::PHASE;
+		record.phase.resize(length);
+		for (uint64_t i = 0; i < length; ++i){
+			uint8_t c;
+			if (!get(c))
+				return false;
+			record.phase[i] = (char)c;
+		}
+		return true;
+	}
+
+	if (tag == TRACE_TAG_STRUCTURE){
+		uint64_t id, type, element_size, elements, cols;
+		if (!getVarint(id) || !getVarint(type) || !getVarint(element_size) || !getVarint(elements) || !getVarint(cols) || id != _structures.size())
+			return false;
+		record.what = traceRecord::STRUCTURE;
+		record.id = (unsigned)id;
+		_structures.push_back({ (unsigned)type, (unsigned)element_size, elements, cols });
+		_last.push_back(0);
+		return true;
+	}
+
+	if (tag & 0xC0)
+		return false; // Unknown tag
+
+	uint64_t id = tag & 0xF, zigzag;
+	if (id == 0xF && !getVarint(id))
+		return false;
+	if (id >= _last.size() || !getVarint(zigzag))
+		return false;
+	record.what = traceRecord::ACCESS;
+	record.id = (unsigned)id;
+	record.kind = (traceaccesskind)((tag >> 4) & 0x3);
+	_last[id] += (uint64_t)((int64_t)(zigzag >> 1) ^ -(int64_t)(zigzag & 1));
+	record.index = _last[id];
+	return true;
+}
+
+// Reuse distances are computed with a Fenwick tree over time which marks, for every block, the time of 
+// its last access: the distance is the number of marks between the previous and the current access. 
+// When time reaches the capacity of the tree, times are renumbered keeping only the marks.
+class reuseStack{
+public:
+	reuseStack() : _now(1){
+		_tree = vector<uint32_t>(MIN_CAPACITY + 1, 0);
+	}
+
+	// Return false for the first access to a block, otherwise the reuse distance in 'distance'
+	bool access(uint64_t block, uint64_t& distance){
+		if (_now == _tree.size())
+			compact();
+		bool reuse = false;
+		auto it = _last.find(block);
+		if (it != _last.end()){
+			distance = prefix(_now - 1) - prefix(it->second);
+			add(it->second, -1);
+			it->second = _now;
+			reuse = true;
+		}
+		else{
+			_last[block] = _now;
+		}
+		add(_now, 1);
+		_now++;
+		return reuse;
+	}
+
+private:
+	static const size_t MIN_CAPACITY = 1 << 16;
+
+	vector<uint32_t> _tree;					// 1-based Fenwick tree
+	size_t _now;
+	unordered_map<uint64_t, size_t> _last;	// Time of the last access of every block
+
+	void add(size_t i, int value){
+		for (; i < _tree.size(); i += i & (~i + 1))
+			_tree[i] += value;
+	}
+
+	uint64_t prefix(size_t i) const{
+		uint64_t sum = 0;
+		for (; i > 0; i -= i & (~i + 1))
+			sum += _tree[i];
+		return sum;
+	}
+
+	void compact(){
+		vector<pair<size_t, uint64_t>> marks;
+		marks.reserve(_last.size());
+		for (auto it = _last.begin(); it != _last.end(); ++it)
+			marks.push_back(make_pair(it->second, it->first));
+		sort(marks.begin(), marks.end());
+
+		_tree = vector<uint32_t>(max(2 * marks.size(), MIN_CAPACITY) + 1, 0);
+		for (size_t i = 0; i < marks.size(); ++i){
+			_last[marks[i].second] = i + 1;
+			_tree[i + 1]++;
+			// Linear time construction
+			const size_t parent = (i + 1) + ((i + 1) & (~(i + 1) + 1));
+			if (parent < _tree.size())
+				_tree[parent] += _tree[i + 1];
+		}
+		for (size_t i = marks.size() + 1; i < _tree.size(); ++i){
+			const size_t parent = i + (i & (~i + 1));
+			if (parent < _tree.size())
+				_tree[parent] += _tree[i];
+		}
+		_now = marks.size() + 1;
+	}
+};
+
+bool reuseDistances(const string& trace_path, unsigned block_size, vector<reuseHistogram>& histograms, vector<traceStructure>& structures){
+
+	traceReader reader;
+	if (!reader.open(trace_path))
+		return false;
+
+	histograms.clear();
+	map<pair<string, unsigned>, size_t> histogram_index;
+	string phase = "init";
+	reuseStack stack;
+
+	traceRecord record;
+	while (reader.next(record)){
+		if (record.what == traceRecord::PHASE){
+			phase = record.phase;
+			continue;
+		}
+		if (record.what != traceRecord::ACCESS)
+			continue;
+
+		const traceStructure& s = reader.structures()[record.id];
+		const uint64_t block = block_size ? record.index * s.element_size / block_size : record.index;
+
+		auto it = histogram_index.find(make_pair(phase, record.id));
+		if (it == histogram_index.end()){
+			it = histogram_index.insert(make_pair(make_pair(phase, record.id), histograms.size())).first;
+			histograms.push_back({ phase, record.id, vector<unsigned long long>(), 0 });
+		}
+		reuseHistogram& h = histograms[it->second];
+
+		uint64_t distance;
+		if (!stack.access(((uint64_t)record.id << 48) | block, distance)){
+			h.cold++;
+			continue;
+		}
+		size_t bin = 0;
+		while (distance){
+			distance >>= 1;
+			bin++;
+		}
+		if (h.bins.size() <= bin)
+			h.bins.resize(bin + 1, 0);
+		h.bins[bin]++;
+	}
+
+	structures = reader.structures();
+	return true;
+}
+
+static string structureName(const traceStructure& s){
+	switch (s.type){
+	case MD_BINARY_MAT: return "binary_mat";
+	case MD_LABELED_MAT: return "labeled_mat";
+	case MD_EQUIVALENCE_VEC: return "equivalence_vec";
+	default: return "other";
+	}
+}
+
+bool writeReuseHistograms(const string& path, const vector<reuseHistogram>& histograms, const vector<traceStructure>& structures){
+
+	ofstream os(path);
+	if (!os.is_open())
+		return false;
+
+	for (size_t s = 0; s < structures.size(); ++s){
+		os << "#Structure " << s << ": " << structureName(structures[s]) << ", " << structures[s].elements << " elements of " << structures[s].element_size << " bytes";
+		if (structures[s].cols)
+			os << ", " << structures[s].cols << " columns";
+		os << endl;
+	}
+
+	size_t bins = 0;
+	for (size_t h = 0; h < histograms.size(); ++h)
+		bins = max(bins, histograms[h].bins.size());
+
+	// Header: one column for every phase and structure
+	os << "#Distance";
+	for (size_t h = 0; h < histograms.size(); ++h)
+		os << "\t" << histograms[h].phase << ":" << histograms[h].structure << "_" << structureName(structures[histograms[h].structure]);
+	os << endl;
+
+	os << "cold";
+	for (size_t h = 0; h < histograms.size(); ++h)
+		os << "\t" << histograms[h].cold;
+	os << endl;
+
+	// Row b reports distances in [2^(b-1), 2^b), labeled by the lower bound
+	for (size_t b = 0; b < bins; ++b){
+		os << (b ? (1ull << (b - 1)) : 0);
+		for (size_t h = 0; h < histograms.size(); ++h)
+			os << "\t" << (b < histograms[h].bins.size() ? histograms[h].bins[b] : 0);
+		os << endl;
+	}
+	return true;
+}
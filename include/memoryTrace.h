@@ -0,0 +1,174 @@
+// Copyright(c) 2016 - Costantino Grana, Federico Bolelli, Lorenzo Baraldi and Roberto Vezzani
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// *Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+// 
+// * Neither the name of YACCLAB nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Kind of a traced memory access
+enum traceaccesskind{
+	TA_UNKNOWN = 0,
+	TA_READ = 1,
+	TA_WRITE = 2,
+};
+
+// Trace file format: the magic string "YTRC" and a version byte, followed by records. The first 
+// byte of a record is a tag:
+//  - 0x00-0x3F: access, bits 4-5 are the kind and bits 0-3 the structure id (0xF means that the 
+//    id follows as varint). Then the difference from the index of the previous access to the same 
+//    structure, zigzag encoded varint. Consecutive accesses are usually close, so most of them take 
+//    two bytes.
+//  - 0x80: phase marker, followed by the length of the name (varint) and the name.
+//  - 0x81: structure definition, followed by id, type, element size, number of elements and number 
+//    of columns (0 for vectors) as varints. Index of matrix element (r,c) is r*cols+c.
+#define TRACE_VERSION 1
+#define TRACE_TAG_PHASE 0x80
+#define TRACE_TAG_STRUCTURE 0x81
+
+class traceWriter{
+public:
+	traceWriter() : _file(nullptr){}
+
+	~traceWriter(){
+		close();
+	}
+
+	bool open(const std::string& path);
+	void close();
+
+	bool isOpen() const{
+		return _file != nullptr;
+	}
+
+	// Define a data structure and return the id to be used for its accesses
+	unsigned addStructure(unsigned type, unsigned element_size, uint64_t elements, uint64_t cols);
+
+	// Mark the beginning of a phase of the algorithm (e.g. "first_scan", "flatten", "second_scan")
+	void phase(const std::string& name);
+
+	void access(unsigned id, uint64_t index, traceaccesskind kind){
+		const int64_t delta = (int64_t)(index - _last[id]);
+		_last[id] = index;
+		if (id < 0xF){
+			put((uint8_t)((kind << 4) | id));
+		}
+		else{
+			put((uint8_t)((kind << 4) | 0xF));
+			putVarint(id);
+		}
+		putVarint(((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63));
+	}
+
+private:
+	static const size_t BUFFER_SIZE = 1 << 20;
+
+	FILE *_file;
+	std::vector<uint8_t> _buffer;
+	std::vector<uint64_t> _last;	// Index of the last access to every structure
+
+	void put(uint8_t byte){
+		_buffer.push_back(byte);
+		if (_buffer.size() >= BUFFER_SIZE)
+			flush();
+	}
+
+	void putVarint(uint64_t value){
+		while (value >= 0x80){
+			put((uint8_t)(value | 0x80));
+			value >>= 7;
+		}
+		put((uint8_t)value);
+	}
+
+	void flush();
+};
+
+struct traceStructure{
+	unsigned type;					// memorydatatype of the structure
+	unsigned element_size;
+	uint64_t elements;
+	uint64_t cols;
+};
+
+struct traceRecord{
+	enum { ACCESS, PHASE, STRUCTURE } what;
+	unsigned id;					// Structure id (ACCESS and STRUCTURE records)
+	uint64_t index;					// Element index (ACCESS records)
+	traceaccesskind kind;			// (ACCESS records)
+	std::string phase;				// Phase name (PHASE records)
+};
+
+class traceReader{
+public:
+	traceReader() : _file(nullptr), _pos(0){}
+
+	~traceReader(){
+		close();
+	}
+
+	bool open(const std::string& path);
+	void close();
+
+	// Read the next record, return false at the end of the trace or if the trace is corrupted
+	bool next(traceRecord& record);
+
+	// Structures defined so far
+	const std::vector<traceStructure>& structures() const{
+		return _structures;
+	}
+
+private:
+	FILE *_file;
+	std::vector<uint8_t> _buffer;
+	size_t _pos;
+	std::vector<traceStructure> _structures;
+	std::vector<uint64_t> _last;
+
+	bool get(uint8_t& byte);
+	bool getVarint(uint64_t& value);
+};
+
+// Histogram of reuse distances of the accesses to a structure during a phase. The reuse distance 
+// of an access is the number of distinct memory blocks accessed (by any structure) since the 
+// previous access to the same block: bins[0] counts distance 0, bins[b] distances in [2^(b-1), 2^b).
+struct reuseHistogram{
+	std::string phase;
+	unsigned structure;
+	std::vector<unsigned long long> bins;
+	unsigned long long cold;		// First accesses to a block
+};
+
+// Replay a trace computing reuse distances with blocks of 'block_size' bytes (0 means one block per 
+// element). Time is O(log(distinct blocks)) per access and memory is proportional to the number of 
+// distinct blocks. Return false if the trace cannot be read.
+bool reuseDistances(const std::string& trace_path, unsigned block_size, std::vector<reuseHistogram>& histograms, std::vector<traceStructure>& structures);
+
+// Write histograms in a gnuplot friendly text file
+bool writeReuseHistograms(const std::string& path, const std::vector<reuseHistogram>& histograms, const std::vector<traceStructure>& structures);
@@ -0,0 +1,234 @@
+// Copyright(c) 2016 - Costantino Grana, Federico Bolelli, Lorenzo Baraldi and Roberto Vezzani
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// *Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+// 
+// * Neither the name of YACCLAB nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "resultsExporter.h"
+#include "memoryTester.h"
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <ctime>
+#include <thread>
+#include <limits>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <cstdlib>
+#else
+#include <unistd.h>
+#endif
+
+using namespace cv;
+using namespace std;
+
+static const char* const structuresNames[MD_SIZE] = { "binary_image", "label_image", "equivalence_vectors", "other" };
+
+hostInfo getHostInfo(){
+	hostInfo host;
+
+#ifdef _WIN32
+	const char *name = getenv("COMPUTERNAME");
+	host.hostname = name ? name : "unknown";
+	host.os = "windows";
+#else
+	char name[256] = { 0 };
+	host.hostname = (gethostname(name, sizeof(name) - 1) == 0) ? name : "unknown";
+#ifdef __APPLE__
+	host.os = "macos";
+#else
+	host.os = "linux";
+#endif
+#endif
+
+	stringstream compiler;
+#if defined(_MSC_VER)
+	compiler << "msvc " << _MSC_VER;
+#elif defined(__clang__)
+	compiler << "clang " << __clang_major__ << "." << __clang_minor__ << "." << __clang_patchlevel__;
+#elif defined(__GNUC__)
+	compiler << "gcc " << __GNUC__ << "." << __GNUC_MINOR__ << "." << __GNUC_PATCHLEVEL__;
+#else
+	compiler << "unknown";
+#endif
+	host.compiler = compiler.str();
+
+	host.cores = thread::hardware_concurrency();
+
+	char date[32];
+	time_t now = time(0);
+	strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+	host.date = date;
+
+	return host;
+}
+
+string cleanName(string name){
+	name.erase(std::remove(name.begin(), name.end(), '\\'), name.end());
+	return name;
+}
+
+static string jsonString(const string& s){
+	stringstream ss;
+	ss << '"';
+	for (size_t i = 0; i < s.size(); ++i){
+		const unsigned char ch = s[i];
+		switch (ch){
+		case '"': ss << "\\\""; break;
+		case '\\': ss << "\\\\"; break;
+		case '\n': ss << "\\n"; break;
+		case '\r': ss << "\\r"; break;
+		case '\t': ss << "\\t"; break;
+		default:
+			if (ch < 0x20)
+				ss << "\\u" << hex << setw(4) << setfill('0') << (int)ch << dec;
+			else
+				ss << ch;
+		}
+	}
+	ss << '"';
+	return ss.str();
+}
+
+// Missing values (images not found) are exported as null
+static string jsonNumber(double value){
+	if (value == numeric_limits<double>::max() || value != value)
+		return "null";
+	stringstream ss;
+	ss << setprecision(10) << value;
+	return ss.str();
+}
+
+bool writeJsonResults(const string& path, const hostInfo& host, const benchmarkResults& results){
+
+	ofstream os(path);
+	if (!os.is_open())
+		return false;
+
+	os << "{" << endl;
+	os << "  \"host\": {" << endl;
+	os << "    \"hostname\": " << jsonString(host.hostname) << "," << endl;
+	os << "    \"os\": " << jsonString(host.os) << "," << endl;
+	os << "    \"compiler\": " << jsonString(host.compiler) << "," << endl;
+	os << "    \"cores\": " << host.cores << "," << endl;
+	os << "    \"date\": " << jsonString(host.date) << endl;
+	os << "  }," << endl;
+
+	// Averages tests
+	os << "  \"averages_tests\": [";
+	for (size_t d = 0; d < results.timings.size(); ++d){
+		const datasetTimings& t = results.timings[d];
+		os << (d ? "," : "") << endl << "    {" << endl;
+		os << "      \"dataset\": " << jsonString(t.dataset) << "," << endl;
+		os << "      \"algorithms\": [";
+		for (size_t a = 0; a < results.algorithms.size(); ++a){
+			os << (a ? "," : "") << endl << "        {" << endl;
+			os << "          \"algorithm\": " << jsonString(cleanName(results.algorithms[a])) << "," << endl;
+			os << "          \"images\": [";
+			bool first = true;
+			for (size_t f = 0; f < t.files.size(); ++f){
+				if (!t.found[f])
+					continue;
+				os << (first ? "" : ",") << endl;
+				os << "            { \"file\": " << jsonString(t.files[f]) << ", \"time_ms\": " << jsonNumber(t.min_res(f, a)) << ", \"labels\": " << t.labels(f, a) << " }";
+				first = false;
+			}
+			os << endl << "          ]" << endl << "        }";
+		}
+		os << endl << "      ]" << endl << "    }";
+	}
+	os << endl << "  ]," << endl;
+
+	// Memory tests
+	os << "  \"memory_tests\": [";
+	for (size_t d = 0; d < results.accesses.size(); ++d){
+		const datasetAccesses& m = results.accesses[d];
+		os << (d ? "," : "") << endl << "    {" << endl;
+		os << "      \"dataset\": " << jsonString(m.dataset) << "," << endl;
+		os << "      \"algorithms\": [";
+		for (int a = 0; a < m.accesses.rows && a < (int)results.memAlgorithms.size(); ++a){
+			os << (a ? "," : "") << endl << "        { \"algorithm\": " << jsonString(cleanName(results.memAlgorithms[a])) << ", \"average_accesses\": { ";
+			for (int s = 0; s < m.accesses.cols && s < MD_SIZE; ++s){
+				os << (s ? ", " : "") << jsonString(structuresNames[s]) << ": " << jsonNumber(m.accesses(a, s));
+			}
+			os << " } }";
+		}
+		os << endl << "      ]" << endl << "    }";
+	}
+	os << endl << "  ]" << endl;
+	os << "}" << endl;
+
+	return true;
+}
+
+// Values containing commas or quotes are quoted
+static string csvString(const string& s){
+	if (s.find_first_of(",\"\n") == string::npos)
+		return s;
+	string quoted = "\"";
+	for (size_t i = 0; i < s.size(); ++i){
+		if (s[i] == '"')
+			quoted += '"';
+		quoted += s[i];
+	}
+	return quoted + "\"";
+}
+
+bool writeCsvResults(const string& path, const hostInfo& host, const benchmarkResults& results){
+
+	ofstream os(path);
+	if (!os.is_open())
+		return false;
+
+	os << setprecision(10);
+	os << "host,date,test,dataset,file,algorithm,metric,value" << endl;
+	const string prefix = csvString(host.hostname) + "," + csvString(host.date) + ",";
+
+	for (size_t d = 0; d < results.timings.size(); ++d){
+		const datasetTimings& t = results.timings[d];
+		for (size_t f = 0; f < t.files.size(); ++f){
+			if (!t.found[f])
+				continue;
+			for (size_t a = 0; a < results.algorithms.size(); ++a){
+				const string row = prefix + "averages," + csvString(t.dataset) + "," + csvString(t.files[f]) + "," + csvString(cleanName(results.algorithms[a])) + ",";
+				os << row << "time_ms," << t.min_res(f, a) << endl;
+				os << row << "labels," << t.labels(f, a) << endl;
+			}
+		}
+	}
+
+	for (size_t d = 0; d < results.accesses.size(); ++d){
+		const datasetAccesses& m = results.accesses[d];
+		for (int a = 0; a < m.accesses.rows && a < (int)results.memAlgorithms.size(); ++a){
+			for (int s = 0; s < m.accesses.cols && s < MD_SIZE; ++s){
+				os << prefix << "memory," << csvString(m.dataset) << ",," << csvString(cleanName(results.memAlgorithms[a])) << "," << structuresNames[s] << "_accesses," << m.accesses(a, s) << endl;
+			}
+		}
+	}
+
+	return true;
+}
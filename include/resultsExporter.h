@@ -0,0 +1,77 @@
+// Copyright(c) 2016 - Costantino Grana, Federico Bolelli, Lorenzo Baraldi and Roberto Vezzani
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// *Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+// 
+// * Neither the name of YACCLAB nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include "opencv2/opencv.hpp"
+#include <string>
+#include <vector>
+
+// Per image results of the averages test on a dataset
+struct datasetTimings{
+	std::string dataset;
+	std::vector<std::string> files;
+	std::vector<bool> found;		// false if the image does not exist
+	cv::Mat1d min_res;				// Minimum execution time in ms: rows represent images, columns represent algorithms
+	cv::Mat1i labels;				// Number of labels: rows represent images, columns represent algorithms
+	cv::Mat1d test_totals;			// Total execution time on the dataset in ms: rows represent test repetitions, columns represent algorithms
+};
+
+// Average memory accesses of the memory test on a dataset
+struct datasetAccesses{
+	std::string dataset;
+	cv::Mat1d accesses;				// Rows represent algorithms, columns represent data structures (see memorydatatype)
+};
+
+// Everything produced by a run of the driver which is exported in machine readable format
+struct benchmarkResults{
+	std::vector<std::string> algorithms;
+	std::vector<std::string> memAlgorithms;
+	std::vector<datasetTimings> timings;
+	std::vector<datasetAccesses> accesses;
+};
+
+// Description of the machine and of the build which produced the results
+struct hostInfo{
+	std::string hostname;
+	std::string os;
+	std::string compiler;
+	unsigned int cores;
+	std::string date;				// Local date and time of the run (ISO 8601)
+};
+
+hostInfo getHostInfo();
+
+// Name of an algorithm without the gnuplot escape characters it may contain, for the exported files
+std::string cleanName(std::string name);
+
+// Write a JSON document with host info and all the results of the run
+bool writeJsonResults(const std::string& path, const hostInfo& host, const benchmarkResults& results);
+
+// Write the same results as a flat CSV table, one value per line:
+// host,date,test,dataset,file,algorithm,metric,value
+bool writeCsvResults(const std::string& path, const hostInfo& host, const benchmarkResults& results);
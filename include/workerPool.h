@@ -0,0 +1,67 @@
+// Copyright(c) 2016 - Costantino Grana, Federico Bolelli, Lorenzo Baraldi and Roberto Vezzani
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// *Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// * Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and / or other materials provided with the distribution.
+// 
+// * Neither the name of YACCLAB nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Number of workers to use when 'requested' is 0: one for every hardware thread
+inline unsigned workersNumber(unsigned requested){
+	if (requested > 0)
+		return requested;
+	return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+// Run task(i, worker) for every i in [0, n) on 'workers' threads (0 means one for every hardware thread). 
+// Indexes are handed out in increasing order from a shared atomic counter, 'worker' in [0, workers) 
+// identifies the thread, so tasks can use per worker resources without locking. Results that must not 
+// depend on scheduling have to be stored by index and combined after the call.
+template <typename Task>
+void parallelFor(size_t n, unsigned workers, Task task){
+	workers = (unsigned)std::min<size_t>(workersNumber(workers), std::max<size_t>(n, 1));
+
+	std::atomic<size_t> next(0);
+	auto work = [&](unsigned worker){
+		for (size_t i = next++; i < n; i = next++)
+			task(i, worker);
+	};
+
+	if (workers == 1){
+		work(0);
+		return;
+	}
+
+	std::vector<std::thread> threads;
+	for (unsigned w = 1; w < workers; ++w)
+		threads.push_back(std::thread(work, w));
+	work(0);
+	for (size_t t = 0; t < threads.size(); ++t)
+		threads[t].join();
+}